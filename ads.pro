@@ -3,7 +3,9 @@ TEMPLATE = subdirs
 SUBDIRS = \
 	src \
 	demo \
-	example
+	example \
+	tests
 
 demo.depends = src
 example.depends = src
+tests.depends = src
@@ -213,6 +213,14 @@ void CDockAreaTabBar::mouseMoveEvent(QMouseEvent* ev)
 		return;
 	}
 
+	// No new drag operation while the floating widget of this area waits
+	// for its drop
+	auto FloatingWidget = d->DockArea->dockContainer()->floatingWidget();
+	if (FloatingWidget && FloatingWidget->isDropPending())
+	{
+		return;
+	}
+
 	int DragDistance = (d->DragStartMousePos - ev->pos()).manhattanLength();
 	if (DragDistance >= CDockManager::startDragDistance())
 	{
@@ -59,14 +59,16 @@ using tTileBarButton = QToolButton;
 struct DockAreaTitleBarPrivate
 {
 	CDockAreaTitleBar* _this;
-	tTileBarButton* TabsMenuButton;
-	tTileBarButton* UndockButton;
-	tTileBarButton* CloseButton;
+	tTileBarButton* TabsMenuButton = nullptr;
+	tTileBarButton* UndockButton = nullptr;
+	tTileBarButton* CloseButton = nullptr;
 	QBoxLayout* TopLayout;
 	CDockAreaWidget* DockArea;
 	CDockAreaTabBar* TabBar;
 	bool MenuOutdated = true;
-	QMenu* TabsMenu;
+	QMenu* TabsMenu = nullptr;
+	bool ButtonVisible[3] = {true, true, true}; ///< applied on button creation
+	bool ButtonEnabled[3] = {true, true, true}; ///< applied on button creation
 
 	/**
 	 * Private data constructor
@@ -74,10 +76,53 @@ struct DockAreaTitleBarPrivate
 	DockAreaTitleBarPrivate(CDockAreaTitleBar* _public);
 
 	/**
-	 * Creates the title bar close and menu buttons
+	 * Creates the title bar close and menu buttons.
+	 * The buttons are created on first show of the title bar or on first
+	 * access via CDockAreaTitleBar::button(), so that dock areas with a
+	 * hidden title bar do not pay for buttons they never display.
 	 */
 	void createButtons();
 
+	/**
+	 * Creates the close button. The button is only added to the layout, if
+	 * the DockAreaHasCloseButton config flag is set.
+	 */
+	void createCloseButton();
+
+	/**
+	 * Creates the tabs menu on first press of the tabs menu button
+	 */
+	void createTabsMenu();
+
+	/**
+	 * Returns the button for the given identifier or a nullptr, if the
+	 * button has not been created yet
+	 */
+	tTileBarButton* existingButton(TitleBarButton which) const
+	{
+		switch (which)
+		{
+		case TitleBarButtonTabsMenu: return TabsMenuButton;
+		case TitleBarButtonUndock: return UndockButton;
+		case TitleBarButtonClose: return CloseButton;
+		default:
+			return nullptr;
+		}
+	}
+
+	/**
+	 * Applies the buffered enabled and visible state to the given button
+	 */
+	void applyButtonState(TitleBarButton which)
+	{
+		auto Button = existingButton(which);
+		Button->setEnabled(ButtonEnabled[which]);
+		if (!ButtonVisible[which])
+		{
+			Button->setVisible(false);
+		}
+	}
+
 	/**
 	 * Creates the internal TabBar
 	 */
@@ -120,10 +165,7 @@ struct DockAreaTitleBarPrivate
     #ifdef Q_OS_LINUX
         Button->setIcon(_this->style()->standardIcon(StandarPixmap));
     #else
-        QPixmap normalPixmap = _this->style()->standardPixmap(StandarPixmap, 0, Button);
-        Icon.addPixmap(internal::createTransparentPixmap(normalPixmap, 0.25), QIcon::Disabled);
-        Icon.addPixmap(normalPixmap, QIcon::Normal);
-        Button->setIcon(Icon);
+        Button->setIcon(CDockManager::iconProvider().standardIcon(StandarPixmap, Button));
     #endif
     }
 };// struct DockAreaTitleBarPrivate
@@ -141,26 +183,25 @@ DockAreaTitleBarPrivate::DockAreaTitleBarPrivate(CDockAreaTitleBar* _public) :
 //============================================================================
 void DockAreaTitleBarPrivate::createButtons()
 {
+	if (TabsMenuButton)
+	{
+		return;
+	}
+
 	QSizePolicy ButtonSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
-    // Tabs menu button
+    // Tabs menu button - the menu is created on first press
 	TabsMenuButton = new tTileBarButton();
 	TabsMenuButton->setObjectName("tabsMenuButton");
 	TabsMenuButton->setAutoRaise(true);
 	TabsMenuButton->setPopupMode(QToolButton::InstantPopup);
     setTitleBarButtonIcon(TabsMenuButton, QStyle::SP_TitleBarUnshadeButton, ads::DockAreaMenuIcon);
-	QMenu* TabsMenu = new QMenu(TabsMenuButton);
-#ifndef QT_NO_TOOLTIP
-	TabsMenu->setToolTipsVisible(true);
-#endif
-	_this->connect(TabsMenu, SIGNAL(aboutToShow()), SLOT(onTabsMenuAboutToShow()));
-	TabsMenuButton->setMenu(TabsMenu);
 #ifndef QT_NO_TOOLTIP
 	TabsMenuButton->setToolTip(QObject::tr("List all tabs"));
 #endif
 	TabsMenuButton->setSizePolicy(ButtonSizePolicy);
 	TopLayout->addWidget(TabsMenuButton, 0);
-	_this->connect(TabsMenuButton->menu(), SIGNAL(triggered(QAction*)),
-		SLOT(onTabsMenuActionTriggered(QAction*)));
+	_this->connect(TabsMenuButton, SIGNAL(pressed()), SLOT(onTabsMenuButtonPressed()));
+	applyButtonState(TitleBarButtonTabsMenu);
 
 
 	// Undock button
@@ -174,9 +215,19 @@ void DockAreaTitleBarPrivate::createButtons()
     UndockButton->setSizePolicy(ButtonSizePolicy);
 	TopLayout->addWidget(UndockButton, 0);
 	_this->connect(UndockButton, SIGNAL(clicked()), SLOT(onUndockButtonClicked()));
+	applyButtonState(TitleBarButtonUndock);
+
+	if (testConfigFlag(CDockManager::DockAreaHasCloseButton))
+	{
+		createCloseButton();
+	}
+}
 
 
-    // Close button
+//============================================================================
+void DockAreaTitleBarPrivate::createCloseButton()
+{
+	QSizePolicy ButtonSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
 	CloseButton = new tTileBarButton();
 	CloseButton->setObjectName("closeButton");
 	CloseButton->setAutoRaise(true);
@@ -198,6 +249,21 @@ void DockAreaTitleBarPrivate::createButtons()
 		TopLayout->addWidget(CloseButton, 0);
 	}
 	_this->connect(CloseButton, SIGNAL(clicked()), SLOT(onCloseButtonClicked()));
+	applyButtonState(TitleBarButtonClose);
+}
+
+
+//============================================================================
+void DockAreaTitleBarPrivate::createTabsMenu()
+{
+	TabsMenu = new QMenu(TabsMenuButton);
+#ifndef QT_NO_TOOLTIP
+	TabsMenu->setToolTipsVisible(true);
+#endif
+	_this->connect(TabsMenu, SIGNAL(aboutToShow()), SLOT(onTabsMenuAboutToShow()));
+	_this->connect(TabsMenu, SIGNAL(triggered(QAction*)),
+		SLOT(onTabsMenuActionTriggered(QAction*)));
+	TabsMenuButton->setMenu(TabsMenu);
 }
 
 
@@ -235,8 +301,6 @@ CDockAreaTitleBar::CDockAreaTitleBar(CDockAreaWidget* parent) :
 	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
 
 	d->createTabBar();
-	d->createButtons();
-
 }
 
 
@@ -269,7 +333,7 @@ void CDockAreaTitleBar::onTabsMenuAboutToShow()
 		return;
 	}
 
-	QMenu* menu = d->TabsMenuButton->menu();
+	QMenu* menu = d->TabsMenu;
 	menu->clear();
 	for (int i = 0; i < d->TabBar->count(); ++i)
 	{
@@ -289,6 +353,20 @@ void CDockAreaTitleBar::onTabsMenuAboutToShow()
 }
 
 
+//============================================================================
+void CDockAreaTitleBar::onTabsMenuButtonPressed()
+{
+	if (d->TabsMenu)
+	{
+		return;
+	}
+
+	// From now on the tool button shows the menu instantly on press
+	d->createTabsMenu();
+	d->TabsMenuButton->showMenu();
+}
+
+
 //============================================================================
 void CDockAreaTitleBar::onCloseButtonClicked()
 {
@@ -334,7 +412,8 @@ void CDockAreaTitleBar::onCurrentTabChanged(int Index)
 	if (d->testConfigFlag(CDockManager::DockAreaCloseButtonClosesTab))
 	{
 		CDockWidget* DockWidget = d->TabBar->tab(Index)->dockWidget();
-		d->CloseButton->setEnabled(DockWidget->features().testFlag(CDockWidget::DockWidgetClosable));
+		setButtonEnabled(TitleBarButtonClose,
+			DockWidget->features().testFlag(CDockWidget::DockWidgetClosable));
 	}
 }
 
@@ -342,13 +421,35 @@ void CDockAreaTitleBar::onCurrentTabChanged(int Index)
 //============================================================================
 QAbstractButton* CDockAreaTitleBar::button(TitleBarButton which) const
 {
-	switch (which)
+	d->createButtons();
+	if (TitleBarButtonClose == which && !d->CloseButton)
+	{
+		d->createCloseButton();
+	}
+	return d->existingButton(which);
+}
+
+
+//============================================================================
+void CDockAreaTitleBar::setButtonVisible(TitleBarButton which, bool Visible)
+{
+	d->ButtonVisible[which] = Visible;
+	auto Button = d->existingButton(which);
+	if (Button)
+	{
+		Button->setVisible(Visible);
+	}
+}
+
+
+//============================================================================
+void CDockAreaTitleBar::setButtonEnabled(TitleBarButton which, bool Enabled)
+{
+	d->ButtonEnabled[which] = Enabled;
+	auto Button = d->existingButton(which);
+	if (Button)
 	{
-	case TitleBarButtonTabsMenu: return d->TabsMenuButton;
-	case TitleBarButtonUndock: return d->UndockButton;
-	case TitleBarButtonClose: return d->CloseButton;
-	default:
-		return nullptr;
+		Button->setEnabled(Enabled);
 	}
 }
 
@@ -361,6 +462,14 @@ void CDockAreaTitleBar::setVisible(bool Visible)
 }
 
 
+//============================================================================
+void CDockAreaTitleBar::showEvent(QShowEvent* event)
+{
+	d->createButtons();
+	Super::showEvent(event);
+}
+
+
 //============================================================================
 void CDockAreaTitleBar::showContextMenu(const QPoint& pos)
 {
@@ -56,12 +56,19 @@ private:
 
 private slots:
 	void onTabsMenuAboutToShow();
+	void onTabsMenuButtonPressed();
 	void onCloseButtonClicked();
 	void onUndockButtonClicked();
 	void onTabsMenuActionTriggered(QAction* Action);
 	void onCurrentTabChanged(int Index);
 	void showContextMenu(const QPoint& pos);
 
+protected:
+	/**
+	 * Creates the title bar buttons on first show
+	 */
+	virtual void showEvent(QShowEvent* event) override;
+
 public slots:
 	/**
 	 * Call this slot to tell the title bar that it should update the tabs menu
@@ -88,10 +95,24 @@ public:
 	CDockAreaTabBar* tabBar() const;
 
 	/**
-	 * Returns the button corresponding to the given title bar button identifier
+	 * Returns the button corresponding to the given title bar button identifier.
+	 * The title bar buttons are created lazily - calling this function
+	 * creates them, if they do not exist yet.
 	 */
 	QAbstractButton* button(TitleBarButton which) const;
 
+	/**
+	 * Shows or hides the given button. If the button has not been created
+	 * yet, the state is applied when it is created.
+	 */
+	void setButtonVisible(TitleBarButton which, bool Visible);
+
+	/**
+	 * Enables or disables the given button. If the button has not been
+	 * created yet, the state is applied when it is created.
+	 */
+	void setButtonEnabled(TitleBarButton which, bool Enabled);
+
 	/**
 	 * Marks the tabs menu outdated before it calls its base class
 	 * implementation
@@ -53,15 +53,13 @@
 #include "DockAreaTabBar.h"
 #include "DockSplitter.h"
 #include "DockAreaTitleBar.h"
+#include "DockLayoutJournal.h"
 
 #include <iostream>
 
 
 namespace ads
 {
-static const char* const INDEX_PROPERTY = "index";
-static const char* const ACTION_PROPERTY = "action";
-
 /**
  * Internal dock area layout mimics stack layout but only inserts the current
  * widget into the internal QLayout object.
@@ -244,7 +242,11 @@ struct DockAreaWidgetPrivate
 	DockAreaLayout*		ContentsLayout	= nullptr;
 	CDockAreaTitleBar*	TitleBar		= nullptr;
 	CDockManager*		DockManager		= nullptr;
+	CDockContainerWidget* DockContainer = nullptr;
+	CDockWidget::DockWidgetFeatures Features = CDockWidget::AllDockWidgetFeatures;
 	bool UpdateTitleBarButtons = false;
+	QString RestoredCurrentDockWidgetName;
+	bool Occluded = false;
 
 	/**
 	 * Private data constructor
@@ -256,6 +258,12 @@ struct DockAreaWidgetPrivate
 	 */
 	void createTitleBar();
 
+	/**
+	 * Recalculates the combined features of all dock widgets and updates
+	 * the features of the dock container if they changed
+	 */
+	void updateFeatures();
+
 	/**
 	 * Returns the dock widget with the given index
 	 */
@@ -273,22 +281,6 @@ struct DockAreaWidgetPrivate
 	}
 
 
-	/**
-	 * Returns the tab action of the given dock widget
-	 */
-	QAction* dockWidgetTabAction(CDockWidget* DockWidget) const
-	{
-		return qvariant_cast<QAction*>(DockWidget->property(ACTION_PROPERTY));
-	}
-
-	/**
-	 * Returns the index of the given dock widget
-	 */
-	int dockWidgetIndex(CDockWidget* DockWidget) const
-	{
-		return DockWidget->property(INDEX_PROPERTY).toInt();
-	}
-
 	/**
 	 * Convenience function for tabbar access
 	 */
@@ -333,20 +325,43 @@ void DockAreaWidgetPrivate::updateTitleBarButtonStates()
 		return;
 	}
 
-	TitleBar->button(TitleBarButtonClose)->setEnabled(
+	TitleBar->setButtonEnabled(TitleBarButtonClose,
 		_this->features().testFlag(CDockWidget::DockWidgetClosable));
-	TitleBar->button(TitleBarButtonUndock)->setEnabled(
+	TitleBar->setButtonEnabled(TitleBarButtonUndock,
 		_this->features().testFlag(CDockWidget::DockWidgetFloatable));
 	UpdateTitleBarButtons = false;
 }
 
 
+//============================================================================
+void DockAreaWidgetPrivate::updateFeatures()
+{
+	CDockWidget::DockWidgetFeatures NewFeatures(CDockWidget::AllDockWidgetFeatures);
+	for (int i = 0; i < ContentsLayout->count(); ++i)
+	{
+		NewFeatures &= dockWidgetAt(i)->features();
+	}
+
+	if (NewFeatures == Features)
+	{
+		return;
+	}
+
+	Features = NewFeatures;
+	if (DockContainer)
+	{
+		DockContainer->updateFeatures();
+	}
+}
+
+
 //============================================================================
 CDockAreaWidget::CDockAreaWidget(CDockManager* DockManager, CDockContainerWidget* parent) :
 	QFrame(parent),
 	d(new DockAreaWidgetPrivate(this))
 {
 	d->DockManager = DockManager;
+	d->DockContainer = parent;
 	d->Layout = new QBoxLayout(QBoxLayout::TopToBottom);
 	d->Layout->setContentsMargins(0, 0, 0, 0);
 	d->Layout->setSpacing(0);
@@ -379,7 +394,28 @@ CDockManager* CDockAreaWidget::dockManager() const
 //============================================================================
 CDockContainerWidget* CDockAreaWidget::dockContainer() const
 {
-	return internal::findParent<CDockContainerWidget*>(this);
+	return d->DockContainer;
+}
+
+
+//============================================================================
+void CDockAreaWidget::setDockContainer(CDockContainerWidget* DockContainer)
+{
+	d->DockContainer = DockContainer;
+}
+
+
+//============================================================================
+bool CDockAreaWidget::event(QEvent* e)
+{
+	// If a dock area is temporarily unparented, it keeps its dock container.
+	// The container resets it, if the area is removed
+	if (e->type() == QEvent::ParentChange && parentWidget())
+	{
+		d->DockContainer = internal::parentDockContainer(parentWidget());
+	}
+
+	return Super::event(e);
 }
 
 
@@ -403,12 +439,14 @@ void CDockAreaWidget::insertDockWidget(int index, CDockWidget* DockWidget,
 	d->tabBar()->insertTab(index, TabWidget);
 	d->tabBar()->blockSignals(false);
 	TabWidget->setVisible(!DockWidget->isClosed());
-	DockWidget->setProperty(INDEX_PROPERTY, index);
 	if (Activate)
 	{
 		setCurrentIndex(index);
 	}
 	DockWidget->setDockArea(this);
+	connect(DockWidget, &CDockWidget::featuresChanged, this,
+		&CDockAreaWidget::onDockWidgetFeaturesChanged);
+	d->updateFeatures();
 	d->updateTitleBarButtonStates();
 }
 
@@ -420,6 +458,9 @@ void CDockAreaWidget::removeDockWidget(CDockWidget* DockWidget)
 	auto NextOpenDockWidget = nextOpenDockWidget(DockWidget);
 
 	d->ContentsLayout->removeWidget(DockWidget);
+	disconnect(DockWidget, &CDockWidget::featuresChanged, this,
+		&CDockAreaWidget::onDockWidgetFeaturesChanged);
+	d->updateFeatures();
 	auto TabWidget = DockWidget->tabWidget();
 	TabWidget->hide();
 	d->tabBar()->removeTab(TabWidget);
@@ -462,7 +503,7 @@ void CDockAreaWidget::hideAreaWithNoVisibleContent()
 	this->toggleView(false);
 
 	// Hide empty parent splitters
-	auto Splitter = internal::findParent<CDockSplitter*>(this);
+	auto Splitter = qobject_cast<CDockSplitter*>(parentWidget());
 	internal::hideEmptyParentSplitters(Splitter);
 
 	//Hide empty floating widget
@@ -480,7 +521,7 @@ void CDockAreaWidget::hideAreaWithNoVisibleContent()
 		FloatingWidget->updateWindowTitle();
 		CDockWidget::emitTopLevelEventForWidget(TopLevelWidget, true);
 	}
-	else if (Container->openedDockAreas().isEmpty())
+	else if (Container->openedDockAreasView().isEmpty())
 	{
 		FloatingWidget->hide();
 	}
@@ -551,6 +592,12 @@ void CDockAreaWidget::setCurrentIndex(int index)
 		return;
     }
 
+	CLayoutJournalScope JournalScope(index != currentIndex() ? dockManager() : nullptr);
+	if (JournalScope.isActive())
+	{
+		JournalScope.record(CDockLayoutJournal::CurrentTabChanged, {dockWidget(index)->objectName()});
+	}
+
     emit currentChanging(index);
     TabBar->setCurrentIndex(index);
 	d->ContentsLayout->setCurrentIndex(index);
@@ -629,6 +676,37 @@ QList<CDockWidget*> CDockAreaWidget::openedDockWidgets() const
 }
 
 
+//============================================================================
+CDockAreaWidget::tDockWidgetView CDockAreaWidget::dockWidgetsView() const
+{
+	return tDockWidgetView(this, d->ContentsLayout->count(),
+		[](const CDockAreaWidget* DockArea, int Index) {return DockArea->dockWidget(Index);});
+}
+
+
+//============================================================================
+CDockAreaWidget::tDockWidgetView CDockAreaWidget::openedDockWidgetsView() const
+{
+	return tDockWidgetView(this, d->ContentsLayout->count(),
+		[](const CDockAreaWidget* DockArea, int Index) {return DockArea->dockWidget(Index);},
+		[](const CDockWidget* DockWidget) {return !DockWidget->isClosed();});
+}
+
+
+//============================================================================
+void CDockAreaWidget::setRestoredCurrentDockWidgetName(const QString& Name)
+{
+	d->RestoredCurrentDockWidgetName = Name;
+}
+
+
+//============================================================================
+QString CDockAreaWidget::restoredCurrentDockWidgetName() const
+{
+	return d->RestoredCurrentDockWidgetName;
+}
+
+
 //============================================================================
 int CDockAreaWidget::indexOfFirstOpenDockWidget() const
 {
@@ -669,6 +747,13 @@ void CDockAreaWidget::reorderDockWidget(int fromIndex, int toIndex)
 		return;
 	}
 
+	CLayoutJournalScope JournalScope(dockManager());
+	if (JournalScope.isActive())
+	{
+		JournalScope.record(CDockLayoutJournal::TabMoved,
+			{dockWidget(fromIndex)->objectName(), QString::number(toIndex)});
+	}
+
 	auto Widget = d->ContentsLayout->widget(fromIndex);
 	d->ContentsLayout->removeWidget(Widget);
 	d->ContentsLayout->insertWidget(toIndex, Widget);
@@ -711,6 +796,30 @@ void CDockAreaWidget::markTitleBarMenuOutdated()
 }
 
 
+//============================================================================
+void CDockAreaWidget::setOccluded(bool Occluded)
+{
+	if (d->Occluded == Occluded)
+	{
+		return;
+	}
+
+	d->Occluded = Occluded;
+	for (auto DockWidget : dockWidgetsView())
+	{
+		DockWidget->updateVisibilityState();
+	}
+	emit occludedChanged(Occluded);
+}
+
+
+//============================================================================
+bool CDockAreaWidget::isOccluded() const
+{
+	return d->Occluded;
+}
+
+
 
 //============================================================================
 void CDockAreaWidget::saveState(QXmlStreamWriter& s) const
@@ -733,39 +842,49 @@ void CDockAreaWidget::saveState(QXmlStreamWriter& s) const
 //============================================================================
 CDockWidget* CDockAreaWidget::nextOpenDockWidget(CDockWidget* DockWidget) const
 {
-	auto OpenDockWidgets = openedDockWidgets();
-	if (OpenDockWidgets.count() > 1 || (OpenDockWidgets.count() == 1 && OpenDockWidgets[0] != DockWidget))
+	// Returns the first open dock widget behind the given one or the last
+	// open dock widget in front of it, if there is no open dock widget behind
+	// it. If DockWidget itself is not open, the first open dock widget is
+	// returned
+	CDockWidget* FirstDockWidget = nullptr;
+	CDockWidget* PreviousDockWidget = nullptr;
+	bool DockWidgetFound = false;
+	for (auto OpenDockWidget : openedDockWidgetsView())
 	{
-		CDockWidget* NextDockWidget;
-		if (OpenDockWidgets.last() == DockWidget)
+		if (OpenDockWidget == DockWidget)
 		{
-			NextDockWidget = OpenDockWidgets[OpenDockWidgets.count() - 2];
+			DockWidgetFound = true;
+			continue;
 		}
-		else
+
+		if (DockWidgetFound)
 		{
-			int NextIndex = OpenDockWidgets.indexOf(DockWidget) + 1;
-			NextDockWidget = OpenDockWidgets[NextIndex];
+			return OpenDockWidget;
 		}
 
-		return NextDockWidget;
-	}
-	else
-	{
-		return nullptr;
+		if (!FirstDockWidget)
+		{
+			FirstDockWidget = OpenDockWidget;
+		}
+		PreviousDockWidget = OpenDockWidget;
 	}
+
+	return DockWidgetFound ? PreviousDockWidget : FirstDockWidget;
 }
 
 
 //============================================================================
 CDockWidget::DockWidgetFeatures CDockAreaWidget::features() const
 {
-	CDockWidget::DockWidgetFeatures Features(CDockWidget::AllDockWidgetFeatures);
-	for (const auto DockWidget : dockWidgets())
-	{
-		Features &= DockWidget->features();
-	}
+	return d->Features;
+}
+
 
-	return Features;
+//============================================================================
+void CDockAreaWidget::onDockWidgetFeaturesChanged()
+{
+	d->updateFeatures();
+	d->updateTitleBarButtonStates();
 }
 
 
@@ -782,6 +901,11 @@ void CDockAreaWidget::toggleView(bool Open)
 void CDockAreaWidget::setVisible(bool Visible)
 {
 	Super::setVisible(Visible);
+	auto ParentSplitter = qobject_cast<CDockSplitter*>(parentWidget());
+	if (ParentSplitter)
+	{
+		ParentSplitter->updateChildVisibility(this);
+	}
 	if (d->UpdateTitleBarButtons)
 	{
 		d->updateTitleBarButtonStates();
@@ -796,6 +920,20 @@ QAbstractButton* CDockAreaWidget::titleBarButton(TitleBarButton which) const
 }
 
 
+//============================================================================
+CDockAreaTitleBar* CDockAreaWidget::titleBar() const
+{
+	return d->TitleBar;
+}
+
+
+//============================================================================
+void CDockAreaWidget::setTitleBarButtonVisible(TitleBarButton which, bool Visible)
+{
+	d->TitleBar->setButtonVisible(which, Visible);
+}
+
+
 //============================================================================
 void CDockAreaWidget::closeArea()
 {
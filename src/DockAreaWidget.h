@@ -44,6 +44,9 @@ struct DockAreaWidgetPrivate;
 class CDockManager;
 class CDockContainerWidget;
 class DockContainerWidgetPrivate;
+struct DockLayoutJournalPrivate;
+struct DockSplitterPrivate;
+class CDockAreaTitleBar;
 
 
 /**
@@ -64,6 +67,8 @@ private:
 	friend class CDockWidget;
 	friend struct DockManagerPrivate;
 	friend class CDockManager;
+	friend struct DockLayoutJournalPrivate;
+	friend struct DockSplitterPrivate;
 
 private slots:
 	void onTabCloseRequested(int Index);
@@ -74,6 +79,11 @@ private slots:
 	 */
 	void reorderDockWidget(int fromIndex, int toIndex);
 
+	/**
+	 * Updates the cached features if the features of a dock widget changed
+	 */
+	void onDockWidgetFeaturesChanged();
+
 protected:
 	/**
 	 * Inserts a dock widget into dock area.
@@ -131,11 +141,47 @@ protected:
 	 */
 	void internalSetCurrentDockWidget(CDockWidget* DockWidget);
 
+	/**
+	 * Stores the name of the current dock widget that has been read from
+	 * the saved state. The dock manager activates this dock widget after
+	 * all dock widgets have been restored.
+	 */
+	void setRestoredCurrentDockWidgetName(const QString& Name);
+
+	/**
+	 * Returns the name set via setRestoredCurrentDockWidgetName()
+	 */
+	QString restoredCurrentDockWidgetName() const;
+
 	/**
 	 * Marks tabs menu to update
 	 */
 	void markTitleBarMenuOutdated();
 
+	/**
+	 * Shows or hides the given title bar button without forcing the
+	 * creation of the lazily created title bar buttons
+	 */
+	void setTitleBarButtonVisible(TitleBarButton which, bool Visible);
+
+	/**
+	 * Called by the dock manager if the occlusion of this dock area by
+	 * floating containers changed
+	 */
+	void setOccluded(bool Occluded);
+
+	/**
+	 * Sets the cached dock container of this dock area.
+	 * Called by the parent splitter and by the dock container if the area
+	 * is moved into another container or removed.
+	 */
+	void setDockContainer(CDockContainerWidget* DockContainer);
+
+	/**
+	 * Updates the cached dock container if the dock area is reparented
+	 */
+	virtual bool event(QEvent* e) override;
+
 protected slots:
 	void toggleView(bool Open);
 
@@ -194,6 +240,21 @@ public:
 	 */
 	QList<CDockWidget*> openedDockWidgets() const;
 
+	using tDockWidgetView = CWidgetView<CDockAreaWidget, CDockWidget>;
+
+	/**
+	 * Returns a non allocating view of all dock widgets in this area.
+	 * Prefer this function over dockWidgets() if you only need to iterate.
+	 */
+	tDockWidgetView dockWidgetsView() const;
+
+	/**
+	 * Returns a non allocating view of all dock widgets that are not closed.
+	 * Prefer this function over openedDockWidgets() if you only need to
+	 * iterate.
+	 */
+	tDockWidgetView openedDockWidgetsView() const;
+
 	/**
 	 * Returns a dock widget by its index
 	 */
@@ -240,9 +301,19 @@ public:
 	 * the whole dock are does not support the flag. I.e. if one single
 	 * dock widget in this area is not closabe, the whole dock are is not
 	 * closable.
+	 * The combined features are cached and updated if a dock widget is
+	 * inserted, removed or if its features change.
 	 */
 	CDockWidget::DockWidgetFeatures features() const;
 
+	/**
+	 * Returns true, if this dock area is completely covered by floating
+	 * containers that are in front of the container of this dock area.
+	 * The dock manager updates the flag if the geometry, the visibility or
+	 * the z order of a floating container changes.
+	 */
+	bool isOccluded() const;
+
 	/**
 	 * Returns the title bar button corresponding to the given title bar
 	 * button identifier
@@ -250,7 +321,13 @@ public:
 	QAbstractButton* titleBarButton(TitleBarButton which) const;
 
 	/**
-	 * Update the close button if visibility changed
+	 * Returns the title bar of this dock area
+	 */
+	CDockAreaTitleBar* titleBar() const;
+
+	/**
+	 * Update the close button and the visible content of the parent
+	 * splitter if visibility changed
 	 */
 	virtual void setVisible(bool Visible) override;
 
@@ -297,6 +374,12 @@ signals:
 	 * via toggle view function
 	 */
 	void viewToggled(bool Open);
+
+	/**
+	 * This signal is emitted if the dock area becomes completely covered by
+	 * floating containers or if it is not covered anymore
+	 */
+	void occludedChanged(bool Occluded);
 }; // class DockAreaWidget
 }
  // namespace ads
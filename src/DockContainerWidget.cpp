@@ -38,18 +38,22 @@
 #include <QDebug>
 #include <QXmlStreamWriter>
 #include <QAbstractButton>
+#include <QTimer>
 
 #include "DockManager.h"
 #include "DockAreaWidget.h"
 #include "DockWidget.h"
 #include "DockingStateReader.h"
+#include "DockLayoutModel.h"
 #include "FloatingDockContainer.h"
 #include "DockOverlay.h"
 #include "ads_globals.h"
 #include "DockSplitter.h"
+#include "DockLayoutJournal.h"
 
 #include <functional>
 #include <iostream>
+#include <numeric>
 
 #if QT_VERSION < 0x050900
 
@@ -121,6 +125,24 @@ static void insertWidgetIntoSplitter(QSplitter* Splitter, QWidget* widget, bool
 	}
 }
 
+/**
+ * Helper function that calculates the depth and the number of splitters of
+ * the given splitter tree
+ */
+static void splitterTreeMetrics(QSplitter* Splitter, int Level, int& Depth, int& Count)
+{
+	Depth = qMax(Depth, Level);
+	Count++;
+	for (int i = 0; i < Splitter->count(); ++i)
+	{
+		auto ChildSplitter = qobject_cast<QSplitter*>(Splitter->widget(i));
+		if (ChildSplitter)
+		{
+			splitterTreeMetrics(ChildSplitter, Level + 1, Depth, Count);
+		}
+	}
+}
+
 /**
  * Private data class of CDockContainerWidget class (pimpl)
  */
@@ -129,6 +151,8 @@ class DockContainerWidgetPrivate
 public:
 	CDockContainerWidget* _this;
 	QPointer<CDockManager> DockManager;
+	CFloatingDockContainer* FloatingWidget = nullptr;
+	CDockWidget::DockWidgetFeatures Features = CDockWidget::AllDockWidgetFeatures;
 	unsigned int zOrderIndex = 0;
 	QList<CDockAreaWidget*> DockAreas;
 	QGridLayout* Layout = nullptr;
@@ -137,6 +161,7 @@ public:
 	CDockAreaWidget* LastAddedAreaCache[5];
 	int VisibleDockAreaCount = -1;
 	CDockAreaWidget* TopLevelDockArea = nullptr;
+	bool NormalizationScheduled = false;
 
 	/**
 	 * Private data constructor
@@ -198,13 +223,13 @@ public:
 	/**
 	 * Adds new dock areas to the internal dock area list
 	 */
-	void addDockAreasToList(const QList<CDockAreaWidget*> NewDockAreas);
+	void addDockAreasToList(const QList<CDockAreaWidget*>& NewDockAreas);
 
 	/**
 	 * Wrapper function for DockAreas append, that ensures that dock area signals
 	 * are properly connected to dock container slots
 	 */
-	void appendDockAreas(const QList<CDockAreaWidget*> NewDockAreas);
+	void appendDockAreas(const QList<CDockAreaWidget*>& NewDockAreas);
 
 	/**
 	 * Save state of child nodes
@@ -212,29 +237,83 @@ public:
 	void saveChildNodesState(QXmlStreamWriter& Stream, QWidget* Widget);
 
 	/**
-	 * Restore state of child nodes.
-	 * \param[in] Stream The data stream that contains the serialized state
-	 * \param[out] CreatedWidget The widget created from parsed data or 0 if
-	 * the parsed widget was an empty splitter
-	 * \param[in] Testing If Testing is true, only the stream data is
-	 * parsed without modifiying anything.
+	 * Adds the node for the given splitter or dock area widget and all its
+	 * child nodes to the layout model and returns the index of the node.
+	 * Returns -1, if the widget is neither a splitter nor a dock area.
+	 */
+	int saveChildNodesState(CDockLayoutModel& Model, QWidget* Widget);
+
+	/**
+	 * Creates the splitter or dock area widget for the given node of the
+	 * layout model. Dock areas that have already been created for a node
+	 * are taken from PrebuiltDockAreas. All dock areas of the created tree
+	 * are appended to NewDockAreas.
+	 * Returns a nullptr, if the node does not contain any known dock widget.
+	 */
+	QWidget* createNodeWidget(const CDockLayoutModel& Model, int NodeIndex,
+		const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas,
+		QList<CDockAreaWidget*>& NewDockAreas);
+
+	/**
+	 * Creates a splitter from a splitter node.
+	 * \see createNodeWidget() for details
 	 */
-	bool restoreChildNodes(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* createSplitterWidget(const CDockLayoutModel& Model, int NodeIndex,
+		const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas,
+		QList<CDockAreaWidget*>& NewDockAreas);
 
 	/**
-	 * Restores a splitter.
-	 * \see restoreChildNodes() for details
+	 * Adds the widgets for the children of the given splitter node to
+	 * Splitter and appends their sizes to Sizes. The children of child
+	 * splitter nodes with the same orientation are added directly to
+	 * Splitter with their sizes scaled to Size. If Size is -1, the sizes of
+	 * the node are used unscaled.
 	 */
-	bool restoreSplitter(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	void addSplitterNodeChildren(QSplitter* Splitter, const CDockLayoutModel& Model,
+		int NodeIndex, int Size, QList<int>& Sizes, bool& Visible,
+		const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas,
+		QList<CDockAreaWidget*>& NewDockAreas);
 
 	/**
-	 * Restores a dock area.
-	 * \see restoreChildNodes() for details
+	 * Creates a dock area from a dock area node and moves all known dock
+	 * widgets into it. Returns a nullptr, if the node does not contain any
+	 * known dock widget.
 	 */
-	bool restoreDockArea(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	CDockAreaWidget* createDockAreaWidget(const CDockLayoutModel& Model, int NodeIndex);
+
+	/**
+	 * Flattens redundant nesting in the splitter tree. Splitters with a
+	 * single child are replaced by their child and the children of a splitter
+	 * with the same orientation like its parent splitter are moved into the
+	 * parent splitter. The sizes of the moved widgets are preserved.
+	 */
+	void normalizeSplitterTree();
+
+	/**
+	 * Normalizes the subtree of the given splitter.
+	 * \see normalizeSplitterTree()
+	 */
+	void normalizeSplitter(QSplitter* Splitter);
+
+	/**
+	 * Normalizes the splitter tree in the next event loop pass. Used for
+	 * removals that may happen in the middle of a drop operation that still
+	 * references the splitters of this container.
+	 */
+	void scheduleNormalization()
+	{
+		if (NormalizationScheduled)
+		{
+			return;
+		}
+
+		NormalizationScheduled = true;
+		QTimer::singleShot(0, _this, [this]()
+		{
+			NormalizationScheduled = false;
+			normalizeSplitterTree();
+		});
+	}
 
 	/**
 	 * Helper function for recursive dumping of layout
@@ -300,10 +379,59 @@ public:
 	{
 		CDockSplitter* s = new CDockSplitter(orientation, parent);
 		s->setOpaqueResize(CDockManager::configFlags().testFlag(CDockManager::OpaqueSplitterResize));
+		if (CDockManager::configFlags().testFlag(CDockManager::ThrottledSplitterResize))
+		{
+			s->setResizeThrottleInterval(CDockSplitter::DefaultResizeThrottleInterval);
+		}
 		s->setChildrenCollapsible(false);
+		QObject::connect(s, &QSplitter::splitterMoved, DockManager.data(), &CDockManager::markLayoutDirty);
+		CDockManager* Manager = DockManager;
+		QObject::connect(s, &QSplitter::splitterMoved, Manager,
+			[s, Manager]()
+			{
+				recordSplitterSizes(s, Manager);
+				Manager->scheduleOcclusionUpdate();
+			});
 		return s;
 	}
 
+	/**
+	 * Adds the sizes of the given splitter to the layout journal
+	 */
+	static void recordSplitterSizes(QSplitter* Splitter, CDockManager* DockManager)
+	{
+		CLayoutJournalScope JournalScope(DockManager);
+		if (!JournalScope.isActive())
+		{
+			return;
+		}
+
+		// The splitter is identified by the first dock area in its subtree
+		// and the number of splitter levels between the area and the splitter
+		int Depth = 0;
+		QWidget* Widget = Splitter->widget(0);
+		while (qobject_cast<QSplitter*>(Widget))
+		{
+			Widget = static_cast<QSplitter*>(Widget)->widget(0);
+			Depth++;
+		}
+
+		auto Anchor = CLayoutJournalScope::areaAnchor(qobject_cast<CDockAreaWidget*>(Widget));
+		if (Anchor.isEmpty())
+		{
+			JournalScope.invalidate();
+			return;
+		}
+
+		QStringList Sizes;
+		for (auto Size : Splitter->sizes())
+		{
+			Sizes.append(QString::number(Size));
+		}
+		JournalScope.record(CDockLayoutJournal::SplitterResized,
+			{Anchor, QString::number(Depth), Sizes.join(',')});
+	}
+
 
 // private slots: ------------------------------------------------------------
 	void onDockAreaViewToggled(bool Visible)
@@ -372,13 +500,13 @@ void DockContainerWidgetPrivate::onVisibleDockAreaCountChanged()
 	if (TopLevelDockArea)
 	{
 		this->TopLevelDockArea = TopLevelDockArea;
-		TopLevelDockArea->titleBarButton(TitleBarButtonUndock)->setVisible(false || !_this->isFloating());
-		TopLevelDockArea->titleBarButton(TitleBarButtonClose)->setVisible(false || !_this->isFloating());
+		TopLevelDockArea->setTitleBarButtonVisible(TitleBarButtonUndock, false || !_this->isFloating());
+		TopLevelDockArea->setTitleBarButtonVisible(TitleBarButtonClose, false || !_this->isFloating());
 	}
 	else if (this->TopLevelDockArea)
 	{
-		this->TopLevelDockArea->titleBarButton(TitleBarButtonUndock)->setVisible(true);
-		this->TopLevelDockArea->titleBarButton(TitleBarButtonClose)->setVisible(true);
+		this->TopLevelDockArea->setTitleBarButtonVisible(TitleBarButtonUndock, true);
+		this->TopLevelDockArea->setTitleBarButtonVisible(TitleBarButtonClose, true);
 		this->TopLevelDockArea = nullptr;
 	}
 }
@@ -489,7 +617,7 @@ void DockContainerWidgetPrivate::dropIntoSection(CFloatingDockContainer* Floatin
 	auto InsertParam = internal::dockAreaInsertParameters(area);
 	auto NewDockAreas = FloatingWidget->dockContainer()->findChildren<CDockAreaWidget*>(
 		QString(), Qt::FindChildrenRecursively);
-	QSplitter* TargetAreaSplitter = internal::findParent<QSplitter*>(TargetArea);
+	QSplitter* TargetAreaSplitter = qobject_cast<QSplitter*>(TargetArea->parentWidget());
 
 	if (!TargetAreaSplitter)
 	{
@@ -632,7 +760,7 @@ void DockContainerWidgetPrivate::moveToNewSection(QWidget* Widget, CDockAreaWidg
 	}
 
 	auto InsertParam = internal::dockAreaInsertParameters(area);
-	QSplitter* TargetAreaSplitter = internal::findParent<QSplitter*>(TargetArea);
+	QSplitter* TargetAreaSplitter = qobject_cast<QSplitter*>(TargetArea->parentWidget());
 	int AreaIndex = TargetAreaSplitter->indexOf(TargetArea);
 	auto Sizes = TargetAreaSplitter->sizes();
 	if (TargetAreaSplitter->orientation() == InsertParam.orientation())
@@ -689,7 +817,7 @@ void DockContainerWidgetPrivate::moveToContainer(QWidget* Widget, DockWidgetArea
 
 
 //============================================================================
-void DockContainerWidgetPrivate::addDockAreasToList(const QList<CDockAreaWidget*> NewDockAreas)
+void DockContainerWidgetPrivate::addDockAreasToList(const QList<CDockAreaWidget*>& NewDockAreas)
 {
 	int CountBefore = DockAreas.count();
 	int NewAreaCount = NewDockAreas.count();
@@ -699,8 +827,8 @@ void DockContainerWidgetPrivate::addDockAreasToList(const QList<CDockAreaWidget*
 	// likely hidden. We need to ensure, that it is visible
 	for (auto DockArea : NewDockAreas)
 	{
-		DockArea->titleBarButton(TitleBarButtonUndock)->setVisible(true);
-		DockArea->titleBarButton(TitleBarButtonClose)->setVisible(true);
+		DockArea->setTitleBarButtonVisible(TitleBarButtonUndock, true);
+		DockArea->setTitleBarButtonVisible(TitleBarButtonClose, true);
 	}
 
 	// We need to ensure, that the dock area title bar is visible. The title bar
@@ -720,7 +848,7 @@ void DockContainerWidgetPrivate::addDockAreasToList(const QList<CDockAreaWidget*
 
 
 //============================================================================
-void DockContainerWidgetPrivate::appendDockAreas(const QList<CDockAreaWidget*> NewDockAreas)
+void DockContainerWidgetPrivate::appendDockAreas(const QList<CDockAreaWidget*>& NewDockAreas)
 {
 	DockAreas.append(NewDockAreas);
 	for (auto DockArea : NewDockAreas)
@@ -730,6 +858,7 @@ void DockContainerWidgetPrivate::appendDockAreas(const QList<CDockAreaWidget*> N
 			_this,
 			std::bind(&DockContainerWidgetPrivate::onDockAreaViewToggled, this, std::placeholders::_1));
 	}
+	_this->updateFeatures();
 }
 
 
@@ -769,162 +898,155 @@ void DockContainerWidgetPrivate::saveChildNodesState(QXmlStreamWriter& s, QWidge
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreSplitter(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+int DockContainerWidgetPrivate::saveChildNodesState(CDockLayoutModel& Model,
+	QWidget* Widget)
 {
-	bool Ok;
-	QString OrientationStr = s.attributes().value("Orientation").toString();
-
-	// Check if the orientation string is right
-	if (!OrientationStr.startsWith("|") && !OrientationStr.startsWith("-"))
-	{
-		return false;
-	}
-
-	// The "|" shall indicate a vertical splitter handle which in turn means
-	// a Horizontal orientation of the splitter layout.
-	bool HorizontalSplitter = OrientationStr.startsWith("|");
-	// In version 0 we had a small bug. The "|" indicated a vertical orientation,
-	// but this is wrong, because only the splitter handle is vertical, the
-	// layout of the splitter is a horizontal layout. We fix this here
-	if (s.fileVersion() == 0)
-	{
-		HorizontalSplitter = !HorizontalSplitter;
-	}
-
-	int Orientation = HorizontalSplitter ? Qt::Horizontal : Qt::Vertical;
-	int WidgetCount = s.attributes().value("Count").toInt(&Ok);
-	if (!Ok)
-	{
-		return false;
-	}
-    ADS_PRINT("Restore NodeSplitter Orientation: " <<  Orientation <<
-            " WidgetCount: " << WidgetCount);
-	QSplitter* Splitter = nullptr;
-	if (!Testing)
-	{
-		Splitter = newSplitter(static_cast<Qt::Orientation>(Orientation));
-	}
-	bool Visible = false;
-	QList<int> Sizes;
-	while (s.readNextStartElement())
+	QSplitter* Splitter = qobject_cast<QSplitter*>(Widget);
+	if (Splitter)
 	{
-		QWidget* ChildNode = nullptr;
-		bool Result = true;
-		if (s.name() == "Splitter")
-		{
-			Result = restoreSplitter(s, ChildNode, Testing);
-		}
-		else if (s.name() == "Area")
-		{
-			Result = restoreDockArea(s, ChildNode, Testing);
-		}
-		else if (s.name() == "Sizes")
+		int SplitterNode = Model.addSplitter(Splitter->orientation());
+		auto Sizes = Splitter->sizes();
+		for (int i = 0; i < Splitter->count(); ++i)
 		{
-			QString sSizes = s.readElementText().trimmed();
-            ADS_PRINT("Sizes: " << sSizes);
-			QTextStream TextStream(&sSizes);
-			while (!TextStream.atEnd())
+			int ChildNode = saveChildNodesState(Model, Splitter->widget(i));
+			if (ChildNode >= 0)
 			{
-				int value;
-				TextStream >> value;
-				Sizes.append(value);
+				Model.addChild(SplitterNode, ChildNode, Sizes[i]);
 			}
 		}
-		else
-		{
-			s.skipCurrentElement();
-		}
-
-		if (!Result)
-		{
-			return false;
-		}
-
-		if (Testing || !ChildNode)
-		{
-			continue;
-		}
-
-        ADS_PRINT("ChildNode isVisible " << ChildNode->isVisible()
-            << " isVisibleTo " << ChildNode->isVisibleTo(Splitter));
-		Splitter->addWidget(ChildNode);
-		Visible |= ChildNode->isVisibleTo(Splitter);
+		return SplitterNode;
 	}
 
-	if (Sizes.count() != WidgetCount)
+	CDockAreaWidget* DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+	if (!DockArea)
 	{
-		return false;
+		return -1;
 	}
 
-	if (!Testing)
+	auto CurrentDockWidget = DockArea->currentDockWidget();
+	int AreaNode = Model.addDockArea(CurrentDockWidget
+		? CurrentDockWidget->objectName() : QString());
+	for (int i = 0; i < DockArea->dockWidgetsCount(); ++i)
 	{
-		if (!Splitter->count())
-		{
-			delete Splitter;
-			Splitter = nullptr;
-		}
-		else
-		{
-			Splitter->setSizes(Sizes);
-			Splitter->setVisible(Visible);
-		}
-		CreatedWidget = Splitter;
+		auto DockWidget = DockArea->dockWidget(i);
+		Model.addDockWidget(AreaNode, DockWidget->objectName(), DockWidget->isClosed());
 	}
-	else
+	return AreaNode;
+}
+
+
+//============================================================================
+QWidget* DockContainerWidgetPrivate::createNodeWidget(const CDockLayoutModel& Model,
+	int NodeIndex, const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas,
+	QList<CDockAreaWidget*>& NewDockAreas)
+{
+	if (Model.node(NodeIndex).Type == CDockLayoutModel::SplitterNode)
 	{
-		CreatedWidget = nullptr;
+		return createSplitterWidget(Model, NodeIndex, PrebuiltDockAreas, NewDockAreas);
 	}
 
-	return true;
+	auto it = PrebuiltDockAreas.constFind(NodeIndex);
+	CDockAreaWidget* DockArea = (it != PrebuiltDockAreas.constEnd())
+		? it.value() : createDockAreaWidget(Model, NodeIndex);
+	if (DockArea)
+	{
+		NewDockAreas.append(DockArea);
+	}
+	return DockArea;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreDockArea(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+QWidget* DockContainerWidgetPrivate::createSplitterWidget(const CDockLayoutModel& Model,
+	int NodeIndex, const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas,
+	QList<CDockAreaWidget*>& NewDockAreas)
 {
-	bool Ok;
-#ifdef ADS_DEBUG_PRINT
-	int Tabs = s.attributes().value("Tabs").toInt(&Ok);
-	if (!Ok)
+	const auto& Node = Model.node(NodeIndex);
+    ADS_PRINT("Restore NodeSplitter Orientation: " <<  Node.Orientation <<
+            " WidgetCount: " << Node.Children.count());
+	QSplitter* Splitter = newSplitter(Node.Orientation);
+	QList<int> Sizes;
+	bool Visible = false;
+	addSplitterNodeChildren(Splitter, Model, NodeIndex, -1, Sizes, Visible,
+		PrebuiltDockAreas, NewDockAreas);
+	if (!Splitter->count())
 	{
-		return false;
+		delete Splitter;
+		return nullptr;
 	}
-#endif
 
-	QString CurrentDockWidget = s.attributes().value("Current").toString();
-    ADS_PRINT("Restore NodeDockArea Tabs: " << Tabs << " Current: "
-            << CurrentDockWidget);
+	Splitter->setSizes(Sizes);
+	Splitter->setVisible(Visible);
+	return Splitter;
+}
 
-	CDockAreaWidget* DockArea = nullptr;
-	if (!Testing)
-	{
-		DockArea = new CDockAreaWidget(DockManager, _this);
-	}
 
-	while (s.readNextStartElement())
+//============================================================================
+void DockContainerWidgetPrivate::addSplitterNodeChildren(QSplitter* Splitter,
+	const CDockLayoutModel& Model, int NodeIndex, int Size, QList<int>& Sizes,
+	bool& Visible, const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas,
+	QList<CDockAreaWidget*>& NewDockAreas)
+{
+	const auto& Node = Model.node(NodeIndex);
+	int SizesSum = std::accumulate(Node.Sizes.begin(), Node.Sizes.end(), 0);
+	for (int i = 0; i < Node.Children.count(); ++i)
 	{
-		if (s.name() != "Widget")
+		int ChildIndex = Node.Children[i];
+		int ChildSize = Node.Sizes.value(i);
+		if (Size >= 0)
 		{
+			ChildSize = SizesSum ? (Size * ChildSize / SizesSum) : (Size / Node.Children.count());
+		}
+
+		// Child splitters with the same orientation are flattened into
+		// this splitter
+		const auto& ChildNode = Model.node(ChildIndex);
+		if (ChildNode.Type == CDockLayoutModel::SplitterNode
+		 && ChildNode.Orientation == Splitter->orientation())
+		{
+			addSplitterNodeChildren(Splitter, Model, ChildIndex, ChildSize, Sizes,
+				Visible, PrebuiltDockAreas, NewDockAreas);
 			continue;
 		}
 
-		auto ObjectName = s.attributes().value("Name");
-		if (ObjectName.isEmpty())
+		QWidget* ChildWidget = createNodeWidget(Model, ChildIndex, PrebuiltDockAreas,
+			NewDockAreas);
+		if (!ChildWidget)
 		{
-			return false;
+			continue;
 		}
 
-		bool Closed = s.attributes().value("Closed").toInt(&Ok);
-		if (!Ok)
+		// A child splitter with only one widget is replaced by its widget
+		QSplitter* ChildSplitter = qobject_cast<QSplitter*>(ChildWidget);
+		if (ChildSplitter && ChildSplitter->count() == 1)
 		{
-			return false;
+			ChildWidget = ChildSplitter->widget(0);
+			ChildWidget->setParent(nullptr);
+			delete ChildSplitter;
 		}
 
-		s.skipCurrentElement();
-		CDockWidget* DockWidget = DockManager->findDockWidget(ObjectName.toString());
-		if (!DockWidget || Testing)
+        ADS_PRINT("ChildNode isVisible " << ChildWidget->isVisible()
+            << " isVisibleTo " << ChildWidget->isVisibleTo(Splitter));
+		Splitter->addWidget(ChildWidget);
+		Sizes.append(ChildSize);
+		Visible |= ChildWidget->isVisibleTo(Splitter);
+	}
+}
+
+
+//============================================================================
+CDockAreaWidget* DockContainerWidgetPrivate::createDockAreaWidget(
+	const CDockLayoutModel& Model, int NodeIndex)
+{
+	const auto& Node = Model.node(NodeIndex);
+    ADS_PRINT("Restore NodeDockArea Tabs: " << Node.DockWidgets.count()
+    	<< " Current: " << Node.CurrentDockWidget);
+
+	CDockAreaWidget* DockArea = new CDockAreaWidget(DockManager, _this);
+	for (const auto& Entry : Node.DockWidgets)
+	{
+		CDockWidget* DockWidget = DockManager->findDockWidget(Entry.Name);
+		if (!DockWidget)
 		{
 			continue;
 		}
@@ -934,58 +1056,19 @@ bool DockContainerWidgetPrivate::restoreDockArea(CDockingStateReader& s,
 		// of the dock areas during application startup
 		DockArea->hide();
 		DockArea->addDockWidget(DockWidget);
-		DockWidget->setToggleViewActionChecked(!Closed);
-		DockWidget->setClosedState(Closed);
-		DockWidget->setProperty(internal::ClosedProperty, Closed);
-		DockWidget->setProperty(internal::DirtyProperty, false);
-	}
-
-	if (Testing)
-	{
-		return true;
+		DockWidget->setToggleViewActionChecked(!Entry.Closed);
+		DockWidget->setClosedState(Entry.Closed);
+		DockWidget->setRestoreState(false, Entry.Closed);
 	}
 
 	if (!DockArea->dockWidgetsCount())
 	{
 		delete DockArea;
-		DockArea = nullptr;
-	}
-	else
-	{
-		DockArea->setProperty("currentDockWidget", CurrentDockWidget);
-		appendDockAreas({DockArea});
-	}
-
-	CreatedWidget = DockArea;
-	return true;
-}
-
-
-//============================================================================
-bool DockContainerWidgetPrivate::restoreChildNodes(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
-{
-	bool Result = true;
-	while (s.readNextStartElement())
-	{
-		if (s.name() == "Splitter")
-		{
-			Result = restoreSplitter(s, CreatedWidget, Testing);
-            ADS_PRINT("Splitter");
-		}
-		else if (s.name() == "Area")
-		{
-			Result = restoreDockArea(s, CreatedWidget, Testing);
-            ADS_PRINT("DockAreaWidget");
-		}
-		else
-		{
-			s.skipCurrentElement();
-            ADS_PRINT("Unknown element");
-		}
+		return nullptr;
 	}
 
-	return Result;
+	DockArea->setRestoredCurrentDockWidgetName(Node.CurrentDockWidget);
+	return DockArea;
 }
 
 
@@ -1113,7 +1196,7 @@ CDockAreaWidget* DockContainerWidgetPrivate::dockWidgetIntoDockArea(DockWidgetAr
 	NewDockArea->addDockWidget(Dockwidget);
 	auto InsertParam = internal::dockAreaInsertParameters(area);
 
-	QSplitter* TargetAreaSplitter = internal::findParent<QSplitter*>(TargetDockArea);
+	QSplitter* TargetAreaSplitter = qobject_cast<QSplitter*>(TargetDockArea->parentWidget());
 	int index = TargetAreaSplitter ->indexOf(TargetDockArea);
 	if (TargetAreaSplitter->orientation() == InsertParam.orientation())
 	{
@@ -1135,12 +1218,84 @@ CDockAreaWidget* DockContainerWidgetPrivate::dockWidgetIntoDockArea(DockWidgetAr
 }
 
 
+//============================================================================
+void DockContainerWidgetPrivate::normalizeSplitterTree()
+{
+	if (!RootSplitter)
+	{
+		return;
+	}
+
+	normalizeSplitter(RootSplitter);
+
+	// A root splitter with only one child splitter is replaced by the child
+	// splitter
+	QSplitter* ChildSplitter = (RootSplitter->count() == 1)
+		? qobject_cast<QSplitter*>(RootSplitter->widget(0)) : nullptr;
+	if (ChildSplitter)
+	{
+		ChildSplitter->setParent(nullptr);
+		QLayoutItem* li = Layout->replaceWidget(RootSplitter, ChildSplitter);
+		delete RootSplitter;
+		RootSplitter = ChildSplitter;
+		delete li;
+	}
+}
+
+
+//============================================================================
+void DockContainerWidgetPrivate::normalizeSplitter(QSplitter* Splitter)
+{
+	int i = 0;
+	while (i < Splitter->count())
+	{
+		QSplitter* ChildSplitter = qobject_cast<QSplitter*>(Splitter->widget(i));
+		if (!ChildSplitter)
+		{
+			++i;
+			continue;
+		}
+
+		normalizeSplitter(ChildSplitter);
+		if (ChildSplitter->count() > 1 && ChildSplitter->orientation() != Splitter->orientation())
+		{
+			++i;
+			continue;
+		}
+
+		// The child splitter is redundant - we move its content into this
+		// splitter and distribute its size among the moved widgets. The moved
+		// widgets are checked again in the next loop iteration
+		auto Sizes = Splitter->sizes();
+		auto ChildSizes = ChildSplitter->sizes();
+		bool LaidOut = std::accumulate(Sizes.begin(), Sizes.end(), 0) > 0;
+		int ChildSize = Sizes.takeAt(i);
+		int ChildSizesSum = std::accumulate(ChildSizes.begin(), ChildSizes.end(), 0);
+		int Count = ChildSplitter->count();
+		for (int j = 0; j < Count; ++j)
+		{
+			Sizes.insert(i + j, ChildSizesSum ? (ChildSize * ChildSizes[j] / ChildSizesSum)
+				: (ChildSize / Count));
+			Splitter->insertWidget(i + j, ChildSplitter->widget(0));
+		}
+		delete ChildSplitter;
+
+		// Sizes of a splitter that has not been laid out yet are all 0
+		if (LaidOut)
+		{
+			Splitter->setSizes(Sizes);
+		}
+	}
+}
+
+
 //============================================================================
 CDockContainerWidget::CDockContainerWidget(CDockManager* DockManager, QWidget *parent) :
 	QFrame(parent),
 	d(new DockContainerWidgetPrivate(this))
 {
 	d->DockManager = DockManager;
+	d->FloatingWidget = internal::findParent<CFloatingDockContainer*>(this);
 	d->isFloating = floatingWidget() != nullptr;
 
 	d->Layout = new QGridLayout();
@@ -1175,6 +1330,17 @@ CDockContainerWidget::~CDockContainerWidget()
 CDockAreaWidget* CDockContainerWidget::addDockWidget(DockWidgetArea area, CDockWidget* Dockwidget,
 	CDockAreaWidget* DockAreaWidget)
 {
+	CLayoutJournalScope JournalScope(d->DockManager);
+	if (JournalScope.isActive())
+	{
+		QStringList Arguments{Dockwidget->objectName()};
+		if (!CLayoutJournalScope::targetArguments(area, DockAreaWidget, this, Dockwidget, Arguments))
+		{
+			JournalScope.invalidate();
+		}
+		JournalScope.record(CDockLayoutJournal::DockWidgetAdded, Arguments);
+	}
+
 	CDockAreaWidget* OldDockArea = Dockwidget->dockAreaWidget();
 	if (OldDockArea)
 	{
@@ -1182,14 +1348,17 @@ CDockAreaWidget* CDockContainerWidget::addDockWidget(DockWidgetArea area, CDockW
 	}
 
 	Dockwidget->setDockManager(d->DockManager);
+	CDockAreaWidget* DockArea;
 	if (DockAreaWidget)
 	{
-		return d->dockWidgetIntoDockArea(area, Dockwidget, DockAreaWidget);
+		DockArea = d->dockWidgetIntoDockArea(area, Dockwidget, DockAreaWidget);
 	}
 	else
 	{
-		return d->dockWidgetIntoContainer(area, Dockwidget);
+		DockArea = d->dockWidgetIntoContainer(area, Dockwidget);
 	}
+	d->normalizeSplitterTree();
+	return DockArea;
 }
 
 //============================================================================
@@ -1220,9 +1389,17 @@ bool CDockContainerWidget::isInFrontOf(CDockContainerWidget* Other) const
 bool CDockContainerWidget::event(QEvent *e)
 {
 	bool Result = QWidget::event(e);
-	if (e->type() == QEvent::WindowActivate)
+	if (e->type() == QEvent::ParentChange)
+	{
+		d->FloatingWidget = internal::findParent<CFloatingDockContainer*>(this);
+	}
+	else if (e->type() == QEvent::WindowActivate)
     {
         d->zOrderIndex = ++zOrderCounter;
+        if (d->DockManager)
+        {
+        	d->DockManager->scheduleOcclusionUpdate();
+        }
     }
 	else if (e->type() == QEvent::Show && !d->zOrderIndex)
 	{
@@ -1253,11 +1430,13 @@ void CDockContainerWidget::removeDockArea(CDockAreaWidget* area)
     ADS_PRINT("CDockContainerWidget::removeDockArea");
 	area->disconnect(this);
 	d->DockAreas.removeAll(area);
-	CDockSplitter* Splitter = internal::findParent<CDockSplitter*>(area);
+	updateFeatures();
+	CDockSplitter* Splitter = qobject_cast<CDockSplitter*>(area->parentWidget());
 
 	// Remove are from parent splitter and recursively hide tree of parent
 	// splitters if it has no visible content
 	area->setParent(nullptr);
+	area->setDockContainer(nullptr);
 	internal::hideEmptyParentSplitters(Splitter);
 
 	// Remove this area from cached areas
@@ -1303,7 +1482,7 @@ void CDockContainerWidget::removeDockArea(CDockAreaWidget* area)
 	else if (Splitter->count() == 1)
 	{
         ADS_PRINT("Replacing splitter with content");
-		QSplitter* ParentSplitter = internal::findParent<QSplitter*>(Splitter);
+		QSplitter* ParentSplitter = qobject_cast<QSplitter*>(Splitter->parentWidget());
 		auto Sizes = ParentSplitter->sizes();
 		QWidget* widget = Splitter->widget(0);
 		widget->setParent(this);
@@ -1314,6 +1493,7 @@ void CDockContainerWidget::removeDockArea(CDockAreaWidget* area)
 	delete Splitter;
 
 emitAndExit:
+	d->scheduleNormalization();
 	CDockWidget* TopLevelWidget = topLevelDockWidget();
 
 	// Updated the title bar visibility of the dock widget if there is only
@@ -1353,6 +1533,23 @@ bool CDockContainerWidget::isFloating() const
 }
 
 
+//============================================================================
+CDockContainerWidget::tDockAreaView CDockContainerWidget::dockAreasView() const
+{
+	return tDockAreaView(this, d->DockAreas.count(),
+		[](const CDockContainerWidget* Container, int Index) {return Container->d->DockAreas[Index];});
+}
+
+
+//============================================================================
+CDockContainerWidget::tDockAreaView CDockContainerWidget::openedDockAreasView() const
+{
+	return tDockAreaView(this, d->DockAreas.count(),
+		[](const CDockContainerWidget* Container, int Index) {return Container->d->DockAreas[Index];},
+		[](const CDockAreaWidget* DockArea) {return !DockArea->isHidden();});
+}
+
+
 //============================================================================
 int CDockContainerWidget::dockAreaCount() const
 {
@@ -1382,56 +1579,81 @@ void CDockContainerWidget::dropFloatingWidget(CFloatingDockContainer* FloatingWi
 	const QPoint& TargetPos)
 {
     ADS_PRINT("CDockContainerWidget::dropFloatingWidget");
-	CDockWidget* SingleDroppedDockWidget = FloatingWidget->topLevelDockWidget();
-	CDockWidget* SingleDockWidget = topLevelDockWidget();
+	CDockAreaWidget* TargetArea;
+	auto dropArea = floatingWidgetDropArea(TargetPos, TargetArea);
+	if (dropArea != InvalidDockWidgetArea)
+	{
+		dropFloatingWidget(FloatingWidget, dropArea, TargetArea);
+	}
+}
+
+
+//============================================================================
+DockWidgetArea CDockContainerWidget::floatingWidgetDropArea(const QPoint& TargetPos,
+	CDockAreaWidget*& TargetArea)
+{
 	CDockAreaWidget* DockArea = dockAreaAt(TargetPos);
-	auto dropArea = InvalidDockWidgetArea;
 	auto ContainerDropArea = d->DockManager->containerOverlay()->dropAreaUnderCursor();
-	bool Dropped = false;
+	TargetArea = nullptr;
 
 	if (DockArea)
 	{
 		auto dropOverlay = d->DockManager->dockAreaOverlay();
 		dropOverlay->setAllowedAreas(AllDockAreas);
-		dropArea = dropOverlay->showOverlay(DockArea);
-		if (ContainerDropArea != InvalidDockWidgetArea &&
-			ContainerDropArea != dropArea)
-		{
-			dropArea = InvalidDockWidgetArea;
-		}
-
-		if (dropArea != InvalidDockWidgetArea)
+		auto dropArea = dropOverlay->showOverlay(DockArea);
+		if (dropArea != InvalidDockWidgetArea &&
+			(ContainerDropArea == InvalidDockWidgetArea || ContainerDropArea == dropArea))
 		{
             ADS_PRINT("Dock Area Drop Content: " << dropArea);
-			d->dropIntoSection(FloatingWidget, DockArea, dropArea);
-			Dropped = true;
+			TargetArea = DockArea;
+			return dropArea;
 		}
 	}
 
 	// mouse is over container
-	if (InvalidDockWidgetArea == dropArea)
+    ADS_PRINT("Container Drop Content: " << ContainerDropArea);
+	return ContainerDropArea;
+}
+
+
+//============================================================================
+void CDockContainerWidget::dropFloatingWidget(CFloatingDockContainer* FloatingWidget,
+	DockWidgetArea Area, CDockAreaWidget* TargetArea)
+{
+	CLayoutJournalScope JournalScope(d->DockManager);
+	if (JournalScope.isActive())
 	{
-		dropArea = ContainerDropArea;
-        ADS_PRINT("Container Drop Content: " << dropArea);
-		if (dropArea != InvalidDockWidgetArea)
+		auto DockWidgets = FloatingWidget->dockWidgets();
+		QStringList Arguments{DockWidgets.isEmpty() ? QString() : DockWidgets.first()->objectName()};
+		if (DockWidgets.isEmpty()
+		 || !CLayoutJournalScope::targetArguments(Area, TargetArea, this, nullptr, Arguments))
 		{
-			d->dropIntoContainer(FloatingWidget, dropArea);
-			Dropped = true;
+			JournalScope.invalidate();
 		}
+		JournalScope.record(CDockLayoutJournal::FloatingWidgetDropped, Arguments);
 	}
 
-	if (Dropped)
+	CDockWidget* SingleDroppedDockWidget = FloatingWidget->topLevelDockWidget();
+	CDockWidget* SingleDockWidget = topLevelDockWidget();
+	if (TargetArea)
 	{
-		FloatingWidget->deleteLater();
+		d->dropIntoSection(FloatingWidget, TargetArea, Area);
+	}
+	else
+	{
+		d->dropIntoContainer(FloatingWidget, Area);
+	}
 
-		// If we dropped a floating widget with only one single dock widget, then we
-		// drop a top level widget that changes from floating to docked now
-		CDockWidget::emitTopLevelEventForWidget(SingleDroppedDockWidget, false);
+	d->normalizeSplitterTree();
+	FloatingWidget->deleteLater();
 
-		// If there was a top level widget before the drop, then it is not top
-		// level widget anymore
-		CDockWidget::emitTopLevelEventForWidget(SingleDockWidget, false);
-	}
+	// If we dropped a floating widget with only one single dock widget, then we
+	// drop a top level widget that changes from floating to docked now
+	CDockWidget::emitTopLevelEventForWidget(SingleDroppedDockWidget, false);
+
+	// If there was a top level widget before the drop, then it is not top
+	// level widget anymore
+	CDockWidget::emitTopLevelEventForWidget(SingleDockWidget, false);
 }
 
 
@@ -1439,7 +1661,6 @@ void CDockContainerWidget::dropFloatingWidget(CFloatingDockContainer* FloatingWi
 void CDockContainerWidget::dropWidget(QWidget* Widget, const QPoint& TargetPos)
 {
     ADS_PRINT("CDockContainerWidget::dropFloatingWidget");
-    CDockWidget* SingleDockWidget = topLevelDockWidget();
 	CDockAreaWidget* DockArea = dockAreaAt(TargetPos);
 	auto dropArea = InvalidDockWidgetArea;
 	auto ContainerDropArea = d->DockManager->containerOverlay()->dropAreaUnderCursor();
@@ -1458,20 +1679,48 @@ void CDockContainerWidget::dropWidget(QWidget* Widget, const QPoint& TargetPos)
 		if (dropArea != InvalidDockWidgetArea)
 		{
             ADS_PRINT("Dock Area Drop Content: " << dropArea);
-            d->moveToNewSection(Widget, DockArea, dropArea);
+            dropWidget(Widget, dropArea, DockArea);
+            return;
 		}
 	}
 
 	// mouse is over container
-	if (InvalidDockWidgetArea == dropArea)
-	{
-		dropArea = ContainerDropArea;
-        ADS_PRINT("Container Drop Content: " << dropArea);
-		if (dropArea != InvalidDockWidgetArea)
+	dropArea = ContainerDropArea;
+    ADS_PRINT("Container Drop Content: " << dropArea);
+	dropWidget(Widget, dropArea, nullptr);
+}
+
+
+//============================================================================
+void CDockContainerWidget::dropWidget(QWidget* Widget, DockWidgetArea Area,
+	CDockAreaWidget* TargetArea)
+{
+	CLayoutJournalScope JournalScope(Area != InvalidDockWidgetArea ? d->DockManager : nullptr);
+	if (JournalScope.isActive())
+	{
+		auto DroppedDockArea = qobject_cast<CDockAreaWidget*>(Widget);
+		auto Operation = DroppedDockArea ? CDockLayoutJournal::DockAreaMoved
+			: CDockLayoutJournal::DockWidgetMoved;
+		QStringList Arguments{DroppedDockArea ? CLayoutJournalScope::areaAnchor(DroppedDockArea)
+			: Widget->objectName()};
+		if (Arguments.first().isEmpty()
+		 || !CLayoutJournalScope::targetArguments(Area, TargetArea, this, Widget, Arguments))
 		{
-			d->moveToContainer(Widget, dropArea);
+			JournalScope.invalidate();
 		}
+		JournalScope.record(Operation, Arguments);
+	}
+
+	CDockWidget* SingleDockWidget = topLevelDockWidget();
+	if (TargetArea && Area != InvalidDockWidgetArea)
+	{
+		d->moveToNewSection(Widget, TargetArea, Area);
+	}
+	else if (Area != InvalidDockWidgetArea)
+	{
+		d->moveToContainer(Widget, Area);
 	}
+	d->normalizeSplitterTree();
 
 	// If there was a top level widget before the drop, then it is not top
 	// level widget anymore
@@ -1506,7 +1755,7 @@ void CDockContainerWidget::saveState(QXmlStreamWriter& s) const
 	if (isFloating())
 	{
 		CFloatingDockContainer* FloatingWidget = floatingWidget();
-		QByteArray Geometry = FloatingWidget->saveGeometry();
+		QByteArray Geometry = FloatingWidget->savedGeometry();
 #if QT_VERSION < 0x050900
         s.writeTextElement("Geometry", qByteArrayToHex(Geometry, ' '));
 #else
@@ -1518,65 +1767,91 @@ void CDockContainerWidget::saveState(QXmlStreamWriter& s) const
 }
 
 
+//============================================================================
+void CDockContainerWidget::saveState(CDockLayoutModel& Model) const
+{
+	int ContainerIndex = Model.addContainer(isFloating(),
+		isFloating() ? floatingWidget()->savedGeometry() : QByteArray());
+	Model.setRootNode(ContainerIndex, d->saveChildNodesState(Model, d->RootSplitter));
+}
+
+
 //============================================================================
 bool CDockContainerWidget::restoreState(CDockingStateReader& s, bool Testing)
 {
-	bool IsFloating = s.attributes().value("Floating").toInt();
-    ADS_PRINT("Restore CDockContainerWidget Floating" << IsFloating);
+	CDockLayoutModel Model;
+	if (!Model.readContainer(s, s.fileVersion()))
+	{
+		return false;
+	}
 
-	QWidget*NewRootSplitter {};
 	if (!Testing)
 	{
-		d->VisibleDockAreaCount = -1;// invalidate the dock area count
-		d->DockAreas.clear();
-		std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
+		restoreState(Model, 0);
 	}
+	return true;
+}
 
-	if (IsFloating)
-	{
-        ADS_PRINT("Restore floating widget");
-		if (!s.readNextStartElement() || s.name() != "Geometry")
-		{
-			return false;
-		}
 
-		QByteArray GeometryString = s.readElementText(CDockingStateReader::ErrorOnUnexpectedElement).toLocal8Bit();
-		QByteArray Geometry = QByteArray::fromHex(GeometryString);
-		if (Geometry.isEmpty())
-		{
-			return false;
-		}
+//============================================================================
+void CDockContainerWidget::restoreState(const CDockLayoutModel& Model, int ContainerIndex,
+	const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas)
+{
+	const auto& Container = Model.container(ContainerIndex);
+    ADS_PRINT("Restore CDockContainerWidget Floating" << Container.Floating);
 
-		if (!Testing)
-		{
-			CFloatingDockContainer* FloatingWidget = floatingWidget();
-			FloatingWidget->restoreGeometry(Geometry);
-		}
-	}
+	d->VisibleDockAreaCount = -1;// invalidate the dock area count
+	d->DockAreas.clear();
+	updateFeatures();
+	std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
 
-	if (!d->restoreChildNodes(s, NewRootSplitter, Testing))
+	CFloatingDockContainer* FloatingWidget = floatingWidget();
+	if (Container.Floating && FloatingWidget)
 	{
-		return false;
+        ADS_PRINT("Restore floating widget");
+		FloatingWidget->restoreGeometryDeferred(Container.Geometry);
 	}
 
-	if (Testing)
+	// The widget tree is created detached from this container and all new
+	// dock areas are registered in one batch
+	QList<CDockAreaWidget*> NewDockAreas;
+	QWidget* NewRootWidget = nullptr;
+	if (Container.RootNode >= 0)
 	{
-		return true;
+		NewRootWidget = d->createNodeWidget(Model, Container.RootNode,
+			PrebuiltDockAreas, NewDockAreas);
 	}
 
-	// If the root splitter is empty, rostoreChildNodes returns a 0 pointer
-	// and we need to create a new empty root splitter
+	// If the root splitter is empty, createNodeWidget returns a 0 pointer
+	// and we need to create a new empty root splitter. If the root node is a
+	// dock area, we need to wrap it into a root splitter
+	QSplitter* NewRootSplitter = qobject_cast<QSplitter*>(NewRootWidget);
 	if (!NewRootSplitter)
 	{
 		NewRootSplitter = d->newSplitter(Qt::Horizontal);
+		if (NewRootWidget)
+		{
+			NewRootSplitter->addWidget(NewRootWidget);
+		}
 	}
 
 	d->Layout->replaceWidget(d->RootSplitter, NewRootSplitter);
 	QSplitter* OldRoot = d->RootSplitter;
-	d->RootSplitter = dynamic_cast<QSplitter*>(NewRootSplitter);
+	d->RootSplitter = NewRootSplitter;
 	OldRoot->deleteLater();
+	d->normalizeSplitterTree();
+	if (!NewDockAreas.isEmpty())
+	{
+		d->appendDockAreas(NewDockAreas);
+	}
+}
 
-	return true;
+
+//============================================================================
+CDockAreaWidget* CDockContainerWidget::createDockArea(const CDockLayoutModel& Model,
+	int NodeIndex)
+{
+	return d->createDockAreaWidget(Model, NodeIndex);
 }
 
 
@@ -1612,6 +1887,26 @@ void CDockContainerWidget::dumpLayout()
 }
 
 
+//============================================================================
+int CDockContainerWidget::splitterDepth() const
+{
+	int Depth = 0;
+	int Count = 0;
+	splitterTreeMetrics(d->RootSplitter, 1, Depth, Count);
+	return Depth;
+}
+
+
+//============================================================================
+int CDockContainerWidget::splitterCount() const
+{
+	int Depth = 0;
+	int Count = 0;
+	splitterTreeMetrics(d->RootSplitter, 1, Depth, Count);
+	return Count;
+}
+
+
 //============================================================================
 CDockAreaWidget* CDockContainerWidget::lastAddedDockAreaWidget(DockWidgetArea area) const
 {
@@ -1627,13 +1922,13 @@ bool CDockContainerWidget::hasTopLevelDockWidget() const
 		return false;
 	}
 
-	auto DockAreas = openedDockAreas();
-	if (DockAreas.count() != 1)
+	auto DockAreas = openedDockAreasView();
+	if (!DockAreas.hasSingleItem())
 	{
 		return false;
 	}
 
-	return DockAreas[0]->openDockWidgetsCount() == 1;
+	return DockAreas.first()->openedDockWidgetsView().hasSingleItem();
 }
 
 
@@ -1646,13 +1941,13 @@ CDockWidget* CDockContainerWidget::topLevelDockWidget() const
 		return nullptr;
 	}
 
-	auto DockWidgets = TopLevelDockArea->openedDockWidgets();
-	if (DockWidgets.count() != 1)
+	auto DockWidgets = TopLevelDockArea->openedDockWidgetsView();
+	if (!DockWidgets.hasSingleItem())
 	{
 		return nullptr;
 	}
 
-	return DockWidgets[0];
+	return DockWidgets.first();
 
 }
 
@@ -1665,13 +1960,13 @@ CDockAreaWidget* CDockContainerWidget::topLevelDockArea() const
 		return nullptr;
 	}
 
-	auto DockAreas = openedDockAreas();
-	if (DockAreas.count() != 1)
+	auto DockAreas = openedDockAreasView();
+	if (!DockAreas.hasSingleItem())
 	{
 		return nullptr;
 	}
 
-	return DockAreas[0];
+	return DockAreas.first();
 }
 
 
@@ -1690,6 +1985,13 @@ QList<CDockWidget*> CDockContainerWidget::dockWidgets() const
 
 //============================================================================
 CDockWidget::DockWidgetFeatures CDockContainerWidget::features() const
+{
+	return d->Features;
+}
+
+
+//============================================================================
+void CDockContainerWidget::updateFeatures()
 {
 	CDockWidget::DockWidgetFeatures Features(CDockWidget::AllDockWidgetFeatures);
 	for (const auto DockArea : d->DockAreas)
@@ -1697,14 +1999,14 @@ CDockWidget::DockWidgetFeatures CDockContainerWidget::features() const
 		Features &= DockArea->features();
 	}
 
-	return Features;
+	d->Features = Features;
 }
 
 
 //============================================================================
 CFloatingDockContainer* CDockContainerWidget::floatingWidget() const
 {
-	return internal::findParent<CFloatingDockContainer*>(this);
+	return d->FloatingWidget;
 }
 
 
@@ -31,6 +31,7 @@
 //                                   INCLUDES
 //============================================================================
 #include <QFrame>
+#include <QHash>
 
 #include "ads_globals.h"
 #include "DockWidget.h"
@@ -50,6 +51,8 @@ struct FloatingDockContainerPrivate;
 class CFloatingOverlay;
 struct FloatingOverlayPrivate;
 class CDockingStateReader;
+class CDockLayoutModel;
+struct DockLayoutJournalPrivate;
 
 /**
  * Container that manages a number of dock areas with single dock widgets
@@ -73,6 +76,7 @@ private:
 	friend class CDockWidget;
 	friend class CFloatingOverlay;
 	friend struct FloatingOverlayPrivate;
+	friend struct DockLayoutJournalPrivate;
 
 protected:
 	/**
@@ -95,11 +99,33 @@ protected:
 	 */
 	void dropFloatingWidget(CFloatingDockContainer* FloatingWidget, const QPoint& TargetPos);
 
+	/**
+	 * Drop floating widget into the given drop area of TargetArea or into
+	 * the container, if TargetArea is a nullptr
+	 */
+	void dropFloatingWidget(CFloatingDockContainer* FloatingWidget, DockWidgetArea Area,
+		CDockAreaWidget* TargetArea);
+
+	/**
+	 * Returns the drop area for a floating widget drop at the given global
+	 * position and sets TargetArea to the dock area the drop applies to or
+	 * to a nullptr for a drop into the container. The drop overlays need to
+	 * be visible.
+	 */
+	DockWidgetArea floatingWidgetDropArea(const QPoint& TargetPos,
+		CDockAreaWidget*& TargetArea);
+
 	/**
 	 * Drop a dock area or a dock widget given in widget parameter
 	 */
 	void dropWidget(QWidget* Widget, const QPoint& TargetPos);
 
+	/**
+	 * Drop a dock area or a dock widget into the given drop area of
+	 * TargetArea or into the container, if TargetArea is a nullptr
+	 */
+	void dropWidget(QWidget* Widget, DockWidgetArea Area, CDockAreaWidget* TargetArea);
+
 	/**
 	 * Adds the given dock area to this container widget
 	 */
@@ -115,6 +141,12 @@ protected:
 	 */
 	void saveState(QXmlStreamWriter& Stream) const;
 
+	/**
+	 * Appends this container with its splitters and dock areas to the given
+	 * layout model
+	 */
+	void saveState(CDockLayoutModel& Model) const;
+
 	/**
 	 * Restores the state from given stream.
 	 * If Testing is true, the function only parses the data from the given
@@ -123,6 +155,22 @@ protected:
 	 */
 	bool restoreState(CDockingStateReader& Stream, bool Testing);
 
+	/**
+	 * Restores the container with the given index from the layout model.
+	 * The model needs to be valid - see CDockLayoutModel::isValid().
+	 * PrebuiltDockAreas maps area node indices to the dock areas that have
+	 * already been created via createDockArea().
+	 */
+	void restoreState(const CDockLayoutModel& Model, int ContainerIndex,
+		const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas = QHash<int, CDockAreaWidget*>());
+
+	/**
+	 * Creates the dock area for the given area node of the layout model
+	 * without inserting it into the layout. Returns a nullptr if the node
+	 * does not contain any known dock widget.
+	 */
+	CDockAreaWidget* createDockArea(const CDockLayoutModel& Model, int NodeIndex);
+
 	/**
 	 * This function returns the last added dock area widget for the given
 	 * area identifier or 0 if no dock area widget has been added for the given
@@ -130,6 +178,12 @@ protected:
 	 */
 	CDockAreaWidget* lastAddedDockAreaWidget(DockWidgetArea area) const;
 
+	/**
+	 * Recalculates the cached features of this container from the features
+	 * of all dock areas. Called by a dock area if its features changed.
+	 */
+	void updateFeatures();
+
 	/**
 	 * This function returns true if this dock area has only one single
 	 * visible dock widget.
@@ -214,6 +268,20 @@ public:
 	 */
 	QList<CDockAreaWidget*> openedDockAreas() const;
 
+	using tDockAreaView = CWidgetView<CDockContainerWidget, CDockAreaWidget>;
+
+	/**
+	 * Returns a non allocating view of all dock areas in this container.
+	 */
+	tDockAreaView dockAreasView() const;
+
+	/**
+	 * Returns a non allocating view of the dock areas that are not closed.
+	 * Prefer this function over openedDockAreas() if you only need to
+	 * iterate or to check if there are any opened dock areas.
+	 */
+	tDockAreaView openedDockAreasView() const;
+
 	/**
 	 * Returns the number of dock areas in this container
 	 */
@@ -229,6 +297,21 @@ public:
 	 */
 	bool isFloating() const;
 
+	/**
+	 * Returns the depth of the splitter tree of this container. A container
+	 * with a root splitter that only contains dock areas has a depth of 1.
+	 * The splitter tree is normalized after each drop, removal and restore
+	 * so redundant nesting does not increase the depth.
+	 */
+	int splitterDepth() const;
+
+	/**
+	 * Returns the number of splitters in the splitter tree of this
+	 * container. The number of nodes of the layout tree is
+	 * splitterCount() + dockAreaCount().
+	 */
+	int splitterCount() const;
+
 	/**
 	 * Dumps the layout for debugging purposes
 	 */
@@ -240,6 +323,8 @@ public:
 	 * A bitwise and is used to combine the flags of all dock widgets. That
 	 * means, if only dock widget does not support a certain flag, the whole
 	 * dock are does not support the flag.
+	 * The combined features are cached and updated if dock areas are added
+	 * or removed or if the features of a dock area change.
 	 */
 	CDockWidget::DockWidgetFeatures features() const;
 
@@ -0,0 +1,261 @@
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockLayoutBuilder.cpp
+/// \date   19.10.2026
+/// \brief  Implementation of CDockLayoutBuilder class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockLayoutBuilder.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "DockManager.h"
+#include "DockWidget.h"
+
+
+namespace ads
+{
+/**
+ * Private data class of CDockLayoutBuilder class (pimpl)
+ */
+struct DockLayoutBuilderPrivate
+{
+	CDockLayoutBuilder* _this;
+	CDockLayoutModel Model;
+	int Container;
+	QList<CDockWidget*> DockWidgets;
+
+	/**
+	 * Private data constructor
+	 */
+	DockLayoutBuilderPrivate(CDockLayoutBuilder* _public);
+
+	/**
+	 * Removes all nodes and adds the empty dock manager container
+	 */
+	void reset();
+
+	/**
+	 * Assigns the given node to the given parent splitter or makes it the
+	 * root node, if Parent is -1
+	 */
+	int appendNode(int Node, int Parent, int Size);
+
+	/**
+	 * Adds the node described by the given JSON object and all its children
+	 */
+	bool readJsonNode(const QJsonObject& Object, int Parent, int Size);
+};
+// struct DockLayoutBuilderPrivate
+
+
+//============================================================================
+DockLayoutBuilderPrivate::DockLayoutBuilderPrivate(CDockLayoutBuilder* _public) :
+	_this(_public)
+{
+	reset();
+}
+
+
+//============================================================================
+void DockLayoutBuilderPrivate::reset()
+{
+	Model.clear();
+	Container = Model.addContainer();
+}
+
+
+//============================================================================
+int DockLayoutBuilderPrivate::appendNode(int Node, int Parent, int Size)
+{
+	if (Parent < 0)
+	{
+		Model.setRootNode(Container, Node);
+	}
+	else
+	{
+		Model.addChild(Parent, Node, Size);
+	}
+	return Node;
+}
+
+
+//============================================================================
+bool DockLayoutBuilderPrivate::readJsonNode(const QJsonObject& Object, int Parent, int Size)
+{
+	if (Object.contains("children"))
+	{
+		auto Orientation = (Object.value("orientation").toString() == "vertical")
+			? Qt::Vertical : Qt::Horizontal;
+		int Splitter = _this->splitter(Orientation, Parent, Size);
+		const auto Children = Object.value("children").toArray();
+		if (Children.isEmpty())
+		{
+			return false;
+		}
+
+		for (const auto& Child : Children)
+		{
+			const auto ChildObject = Child.toObject();
+			if (!readJsonNode(ChildObject, Splitter,
+				ChildObject.value("size").toInt(CDockLayoutBuilder::DefaultSize)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const auto DockWidgetNames = Object.value("dockWidgets").toArray();
+	if (DockWidgetNames.isEmpty())
+	{
+		return false;
+	}
+
+	int Area = _this->area(Parent, Size);
+	for (const auto& Name : DockWidgetNames)
+	{
+		_this->addDockWidget(Area, Name.toString());
+	}
+
+	const auto Current = Object.value("current").toString();
+	if (!Current.isEmpty())
+	{
+		Model.setCurrentDockWidget(Area, Current);
+	}
+	return true;
+}
+
+
+//============================================================================
+CDockLayoutBuilder::CDockLayoutBuilder() :
+	d(new DockLayoutBuilderPrivate(this))
+{
+
+}
+
+
+//============================================================================
+CDockLayoutBuilder::~CDockLayoutBuilder()
+{
+	delete d;
+}
+
+
+//============================================================================
+int CDockLayoutBuilder::splitter(Qt::Orientation Orientation, int Parent, int Size)
+{
+	return d->appendNode(d->Model.addSplitter(Orientation), Parent, Size);
+}
+
+
+//============================================================================
+int CDockLayoutBuilder::area(int Parent, int Size)
+{
+	return d->appendNode(d->Model.addDockArea(), Parent, Size);
+}
+
+
+//============================================================================
+void CDockLayoutBuilder::addDockWidget(int Area, CDockWidget* DockWidget, bool Current)
+{
+	registerDockWidget(DockWidget);
+	addDockWidget(Area, DockWidget->objectName(), Current);
+}
+
+
+//============================================================================
+void CDockLayoutBuilder::addDockWidget(int Area, const QString& Name, bool Current)
+{
+	d->Model.addDockWidget(Area, Name);
+	if (Current || d->Model.node(Area).CurrentDockWidget.isEmpty())
+	{
+		d->Model.setCurrentDockWidget(Area, Name);
+	}
+}
+
+
+//============================================================================
+void CDockLayoutBuilder::registerDockWidget(CDockWidget* DockWidget)
+{
+	if (!d->DockWidgets.contains(DockWidget))
+	{
+		d->DockWidgets.append(DockWidget);
+	}
+}
+
+
+//============================================================================
+bool CDockLayoutBuilder::fromJson(const QByteArray& Json)
+{
+	d->reset();
+	QJsonParseError Error;
+	auto Document = QJsonDocument::fromJson(Json, &Error);
+	if (Error.error != QJsonParseError::NoError || !Document.isObject())
+	{
+		ADS_PRINT("CDockLayoutBuilder::fromJson: " << Error.errorString());
+		return false;
+	}
+
+	if (!d->readJsonNode(Document.object(), -1, DefaultSize))
+	{
+		d->reset();
+		return false;
+	}
+	return true;
+}
+
+
+//============================================================================
+const CDockLayoutModel& CDockLayoutBuilder::model() const
+{
+	return d->Model;
+}
+
+
+//============================================================================
+bool CDockLayoutBuilder::build(CDockManager* DockManager) const
+{
+	if (!d->Model.isValid() || DockManager->isRestoringState())
+	{
+		return false;
+	}
+
+	for (auto DockWidget : d->DockWidgets)
+	{
+		if (DockManager->findDockWidget(DockWidget->objectName()) != DockWidget)
+		{
+			DockManager->registerDockWidget(DockWidget);
+		}
+	}
+
+	return DockManager->restoreState(d->Model);
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockLayoutBuilder.cpp
@@ -0,0 +1,152 @@
+#ifndef DockLayoutBuilderH
+#define DockLayoutBuilderH
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockLayoutBuilder.h
+/// \date   19.10.2026
+/// \brief  Declaration of CDockLayoutBuilder class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QList>
+
+#include "ads_globals.h"
+#include "DockLayoutModel.h"
+
+namespace ads
+{
+class CDockManager;
+class CDockWidget;
+struct DockLayoutBuilderPrivate;
+
+/**
+ * Declarative builder for the complete layout of a dock manager.
+ * Instead of adding dock widgets one by one via
+ * CDockManager::addDockWidget(), which restructures the splitter tree with
+ * each call, the builder describes the final tree of splitters and dock
+ * areas with their sizes. build() then creates the complete widget
+ * hierarchy in a single pass like restoring a saved state.
+ * \code
+ * CDockLayoutBuilder Builder;
+ * int Root = Builder.splitter(Qt::Horizontal);
+ * int Left = Builder.area(Root, 200);
+ * Builder.addDockWidget(Left, ProjectDockWidget);
+ * int Right = Builder.splitter(Qt::Vertical, Root, 800);
+ * Builder.addDockWidget(Builder.area(Right, 600), EditorDockWidget);
+ * Builder.addDockWidget(Builder.area(Right, 200), OutputDockWidget);
+ * Builder.build(DockManager);
+ * \endcode
+ * The tree can also be read from JSON. Splitter objects contain an
+ * "orientation" ("horizontal" or "vertical") and a "children" array, dock
+ * area objects contain a "dockWidgets" array with the object names of the
+ * dock widgets and an optional "current" dock widget name. Each child may
+ * have a relative "size".
+ * \code
+ * {"orientation": "horizontal", "children": [
+ *     {"size": 200, "dockWidgets": ["Project"]},
+ *     {"size": 800, "dockWidgets": ["Editor", "Output"], "current": "Editor"}
+ * ]}
+ * \endcode
+ */
+class ADS_EXPORT CDockLayoutBuilder
+{
+private:
+	DockLayoutBuilderPrivate* d; ///< private data (pimpl)
+	friend struct DockLayoutBuilderPrivate;
+	Q_DISABLE_COPY(CDockLayoutBuilder)
+
+public:
+	/**
+	 * Default relative size of a splitter child
+	 */
+	static const int DefaultSize = 100;
+
+	/**
+	 * Creates an empty builder
+	 */
+	CDockLayoutBuilder();
+
+	/**
+	 * Destructor
+	 */
+	~CDockLayoutBuilder();
+
+	/**
+	 * Adds a new splitter node to the given parent splitter and returns its
+	 * index. If Parent is -1, the splitter becomes the root node. Size is
+	 * the size of the new node relative to its siblings.
+	 */
+	int splitter(Qt::Orientation Orientation, int Parent = -1, int Size = DefaultSize);
+
+	/**
+	 * Adds a new dock area node to the given parent splitter and returns its
+	 * index. If Parent is -1, the dock area becomes the root node.
+	 */
+	int area(int Parent = -1, int Size = DefaultSize);
+
+	/**
+	 * Adds the given dock widget as tab to the given dock area node.
+	 * The dock widget is registered in the dock manager by build().
+	 * The first dock widget of an area is the current one, if no dock
+	 * widget is added with Current set to true.
+	 */
+	void addDockWidget(int Area, CDockWidget* DockWidget, bool Current = false);
+
+	/**
+	 * Adds the dock widget with the given object name as tab to the given
+	 * dock area node. The dock widget needs to be registered in the dock
+	 * manager or passed to registerDockWidget() before build() is called.
+	 */
+	void addDockWidget(int Area, const QString& Name, bool Current = false);
+
+	/**
+	 * Registers the given dock widget in the dock manager when build() is
+	 * called. Use this function to provide the dock widgets that are
+	 * referenced by name from a JSON description. Registered dock widgets
+	 * that are not part of the layout are closed.
+	 */
+	void registerDockWidget(CDockWidget* DockWidget);
+
+	/**
+	 * Replaces the layout tree with the tree read from the given JSON data.
+	 * Returns false, if the JSON data is not a valid layout tree.
+	 */
+	bool fromJson(const QByteArray& Json);
+
+	/**
+	 * Returns the layout model that has been built
+	 */
+	const CDockLayoutModel& model() const;
+
+	/**
+	 * Registers all dock widgets and replaces the complete layout of the
+	 * given dock manager with the built layout. Returns false and leaves
+	 * the dock manager unchanged, if the layout is not valid.
+	 */
+	bool build(CDockManager* DockManager) const;
+}; // class CDockLayoutBuilder
+} // namespace ads
+
+//-----------------------------------------------------------------------------
+#endif // DockLayoutBuilderH
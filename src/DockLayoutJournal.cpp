@@ -0,0 +1,675 @@
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockLayoutJournal.cpp
+/// \date   19.10.2026
+/// \brief  Implementation of CDockLayoutJournal class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockLayoutJournal.h"
+
+#include <QIODevice>
+#include <QFileDevice>
+#include <QPointer>
+#include <QSplitter>
+#include <QTimer>
+#include <QUrl>
+
+#include "DockManager.h"
+#include "DockWidget.h"
+#include "DockAreaWidget.h"
+#include "DockContainerWidget.h"
+#include "FloatingDockContainer.h"
+
+
+namespace ads
+{
+/**
+ * Delay for writing coalesced splitter and geometry records
+ */
+static const int PendingRecordDelayMs = 500;
+
+static const char* const OperationNames[CDockLayoutJournal::OperationCount] =
+{
+	"dock",
+	"move",
+	"movearea",
+	"dropfloating",
+	"float",
+	"floatarea",
+	"close",
+	"open",
+	"sizes",
+	"tab",
+	"current",
+	"geometry",
+	"remove"
+};
+
+
+//============================================================================
+static QByteArray encodeArgument(const QString& Argument)
+{
+	return Argument.isEmpty() ? QByteArray("*") : QUrl::toPercentEncoding(Argument);
+}
+
+
+//============================================================================
+static QString decodeArgument(const QByteArray& Argument)
+{
+	if (Argument.isEmpty() || Argument == "*")
+	{
+		return QString();
+	}
+	return QString::fromUtf8(QByteArray::fromPercentEncoding(Argument));
+}
+
+
+/**
+ * Private data class of CDockLayoutJournal class (pimpl)
+ */
+struct DockLayoutJournalPrivate
+{
+	CDockLayoutJournal* _this;
+	CDockManager* DockManager;
+	QList<QByteArray> Records;
+	QPointer<QIODevice> Device;
+	int CompactionThreshold = 0;
+	int SuspendCount = 0;
+	bool Replaying = false;
+	bool CompactionScheduled = false;
+	QByteArray PendingKey;
+	QByteArray PendingRecord;
+	QTimer* PendingTimer;
+
+	/**
+	 * Private data constructor
+	 */
+	DockLayoutJournalPrivate(CDockLayoutJournal* _public);
+
+	/**
+	 * Appends the record to the list of records and writes it to the device
+	 */
+	void write(const QByteArray& Record);
+
+	/**
+	 * Writes a pending coalesced record
+	 */
+	void flushPending();
+
+	/**
+	 * Compacts the journal as soon as control returns to the event loop
+	 */
+	void scheduleCompaction();
+
+	/**
+	 * Resolves the drop target given in the record fields starting at Index
+	 */
+	bool resolveTarget(const QList<QByteArray>& Fields, int Index, DockWidgetArea& Area,
+		CDockAreaWidget*& TargetArea, CDockContainerWidget*& TargetContainer) const;
+
+	/**
+	 * Replays a single record
+	 */
+	bool replayRecord(const QByteArray& Record);
+};
+// struct DockLayoutJournalPrivate
+
+
+//============================================================================
+DockLayoutJournalPrivate::DockLayoutJournalPrivate(CDockLayoutJournal* _public) :
+	_this(_public)
+{
+
+}
+
+
+//============================================================================
+void DockLayoutJournalPrivate::write(const QByteArray& Record)
+{
+	Records.append(Record);
+	if (Device && Device->isWritable())
+	{
+		Device->write(Record + '\n');
+	}
+	emit _this->recordAppended(Record);
+
+	if (CompactionThreshold > 0 && Records.count() >= CompactionThreshold)
+	{
+		scheduleCompaction();
+	}
+}
+
+
+//============================================================================
+void DockLayoutJournalPrivate::flushPending()
+{
+	PendingTimer->stop();
+	if (PendingRecord.isEmpty())
+	{
+		return;
+	}
+
+	auto Record = PendingRecord;
+	PendingRecord.clear();
+	PendingKey.clear();
+	write(Record);
+}
+
+
+//============================================================================
+void DockLayoutJournalPrivate::scheduleCompaction()
+{
+	// We do not compact immediately because the journal is written at the
+	// end of an operation. At this point i.e. a dropped floating widget
+	// is not deleted yet and would be part of the snapshot
+	if (CompactionScheduled)
+	{
+		return;
+	}
+
+	CompactionScheduled = true;
+	QMetaObject::invokeMethod(_this, "compact", Qt::QueuedConnection);
+}
+
+
+//============================================================================
+bool DockLayoutJournalPrivate::resolveTarget(const QList<QByteArray>& Fields,
+	int Index, DockWidgetArea& Area, CDockAreaWidget*& TargetArea,
+	CDockContainerWidget*& TargetContainer) const
+{
+	bool Ok;
+	Area = static_cast<DockWidgetArea>(Fields.value(Index).toInt(&Ok));
+	if (!Ok)
+	{
+		return false;
+	}
+
+	TargetArea = nullptr;
+	auto AreaAnchor = decodeArgument(Fields.value(Index + 1));
+	if (!AreaAnchor.isEmpty())
+	{
+		auto DockWidget = DockManager->findDockWidget(AreaAnchor);
+		TargetArea = DockWidget ? DockWidget->dockAreaWidget() : nullptr;
+		TargetContainer = TargetArea ? TargetArea->dockContainer() : nullptr;
+		return TargetContainer != nullptr;
+	}
+
+	auto ContainerAnchor = decodeArgument(Fields.value(Index + 2));
+	if (ContainerAnchor.isEmpty())
+	{
+		TargetContainer = DockManager;
+		return true;
+	}
+
+	auto DockWidget = DockManager->findDockWidget(ContainerAnchor);
+	TargetContainer = DockWidget ? DockWidget->dockContainer() : nullptr;
+	return TargetContainer != nullptr;
+}
+
+
+//============================================================================
+bool DockLayoutJournalPrivate::replayRecord(const QByteArray& Record)
+{
+	auto Fields = Record.split(' ');
+	int Operation = -1;
+	for (int i = 0; i < CDockLayoutJournal::OperationCount; ++i)
+	{
+		if (Fields.at(0) == OperationNames[i])
+		{
+			Operation = i;
+			break;
+		}
+	}
+
+	auto DockWidget = DockManager->findDockWidget(decodeArgument(Fields.value(1)));
+	if (Operation < 0 || !DockWidget)
+	{
+		return false;
+	}
+
+	auto DockArea = DockWidget->dockAreaWidget();
+	DockWidgetArea Area;
+	CDockAreaWidget* TargetArea;
+	CDockContainerWidget* TargetContainer;
+	switch (Operation)
+	{
+	case CDockLayoutJournal::DockWidgetAdded:
+		 if (!resolveTarget(Fields, 2, Area, TargetArea, TargetContainer))
+		 {
+			 return false;
+		 }
+		 TargetContainer->addDockWidget(Area, DockWidget, TargetArea);
+		 break;
+
+	case CDockLayoutJournal::DockWidgetMoved:
+	case CDockLayoutJournal::DockAreaMoved:
+		 if (!resolveTarget(Fields, 2, Area, TargetArea, TargetContainer))
+		 {
+			 return false;
+		 }
+		 if (CDockLayoutJournal::DockWidgetMoved == Operation)
+		 {
+			 TargetContainer->dropWidget(DockWidget, Area, TargetArea);
+		 }
+		 else if (DockArea)
+		 {
+			 TargetContainer->dropWidget(DockArea, Area, TargetArea);
+		 }
+		 break;
+
+	case CDockLayoutJournal::FloatingWidgetDropped:
+		{
+			auto FloatingWidget = DockWidget->dockContainer()
+				? DockWidget->dockContainer()->floatingWidget() : nullptr;
+			if (!FloatingWidget || !resolveTarget(Fields, 2, Area, TargetArea, TargetContainer))
+			{
+				return false;
+			}
+			TargetContainer->dropFloatingWidget(FloatingWidget, Area, TargetArea);
+		}
+		break;
+
+	case CDockLayoutJournal::DockWidgetFloated:
+		 DockManager->showFloatingWidget(new CFloatingDockContainer(DockWidget));
+		 break;
+
+	case CDockLayoutJournal::DockAreaFloated:
+		 if (!DockArea)
+		 {
+			 return false;
+		 }
+		 DockManager->showFloatingWidget(new CFloatingDockContainer(DockArea));
+		 break;
+
+	case CDockLayoutJournal::DockWidgetClosed:
+	case CDockLayoutJournal::DockWidgetOpened:
+		 DockWidget->toggleView(CDockLayoutJournal::DockWidgetOpened == Operation);
+		 break;
+
+	case CDockLayoutJournal::SplitterResized:
+		{
+			// The splitter is identified by the number of splitter levels
+			// between the dock area of the anchor dock widget and the splitter
+			int Depth = Fields.value(2).toInt();
+			QWidget* Widget = DockArea;
+			QSplitter* Splitter = nullptr;
+			for (int i = 0; Widget && i <= Depth; ++i)
+			{
+				Splitter = qobject_cast<QSplitter*>(Widget->parentWidget());
+				Widget = Splitter;
+			}
+
+			QList<int> Sizes;
+			for (const auto& Size : decodeArgument(Fields.value(3)).split(','))
+			{
+				Sizes.append(Size.toInt());
+			}
+
+			if (!Splitter || Splitter->count() != Sizes.count())
+			{
+				return false;
+			}
+			Splitter->setSizes(Sizes);
+		}
+		break;
+
+	case CDockLayoutJournal::TabMoved:
+		 if (!DockArea || DockArea->dockWidgetsCount() < 2)
+		 {
+			 return false;
+		 }
+		 else
+		 {
+			 int Index = qBound(0, Fields.value(2).toInt(), DockArea->dockWidgetsCount() - 1);
+			 bool IsCurrent = (DockArea->currentDockWidget() == DockWidget);
+			 DockArea->removeDockWidget(DockWidget);
+			 DockArea->insertDockWidget(Index, DockWidget, IsCurrent);
+		 }
+		 break;
+
+	case CDockLayoutJournal::CurrentTabChanged:
+		 if (!DockArea)
+		 {
+			 return false;
+		 }
+		 DockArea->setCurrentDockWidget(DockWidget);
+		 break;
+
+	case CDockLayoutJournal::FloatingGeometryChanged:
+		{
+			auto FloatingWidget = DockWidget->dockContainer()
+				? DockWidget->dockContainer()->floatingWidget() : nullptr;
+			if (!FloatingWidget)
+			{
+				return false;
+			}
+			FloatingWidget->restoreGeometryDeferred(QByteArray::fromHex(Fields.value(2)));
+		}
+		break;
+
+	case CDockLayoutJournal::DockWidgetRemoved:
+		 DockManager->removeDockWidget(DockWidget);
+		 break;
+
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+
+//============================================================================
+CDockLayoutJournal::CDockLayoutJournal(CDockManager* DockManager) :
+	QObject(DockManager),
+	d(new DockLayoutJournalPrivate(this))
+{
+	d->DockManager = DockManager;
+	d->PendingTimer = new QTimer(this);
+	d->PendingTimer->setSingleShot(true);
+	d->PendingTimer->setInterval(PendingRecordDelayMs);
+	connect(d->PendingTimer, &QTimer::timeout, this, [this]() {d->flushPending();});
+}
+
+
+//============================================================================
+CDockLayoutJournal::~CDockLayoutJournal()
+{
+	d->flushPending();
+	delete d;
+}
+
+
+//============================================================================
+void CDockLayoutJournal::append(int Operation, const QStringList& Arguments)
+{
+	QByteArray Record = OperationNames[Operation];
+	for (const auto& Argument : Arguments)
+	{
+		Record += ' ';
+		Record += encodeArgument(Argument);
+	}
+
+	// Splitter and floating widget geometry changes are reported
+	// continuously while the user drags. We only keep the last record
+	// for the same splitter or floating widget. The key is the record
+	// without the last field that contains the new sizes or geometry
+	if (SplitterResized == Operation || FloatingGeometryChanged == Operation)
+	{
+		auto Key = Record.left(Record.lastIndexOf(' '));
+		if (Key != d->PendingKey)
+		{
+			d->flushPending();
+		}
+		d->PendingKey = Key;
+		d->PendingRecord = Record;
+		d->PendingTimer->start();
+		return;
+	}
+
+	d->flushPending();
+	d->write(Record);
+}
+
+
+//============================================================================
+void CDockLayoutJournal::invalidate()
+{
+	d->scheduleCompaction();
+}
+
+
+//============================================================================
+void CDockLayoutJournal::setDevice(QIODevice* Device)
+{
+	d->flushPending();
+	d->Device = Device;
+}
+
+
+//============================================================================
+QIODevice* CDockLayoutJournal::device() const
+{
+	return d->Device;
+}
+
+
+//============================================================================
+void CDockLayoutJournal::setCompactionThreshold(int Count)
+{
+	d->CompactionThreshold = Count;
+}
+
+
+//============================================================================
+int CDockLayoutJournal::compactionThreshold() const
+{
+	return d->CompactionThreshold;
+}
+
+
+//============================================================================
+int CDockLayoutJournal::count() const
+{
+	return d->Records.count() + (d->PendingRecord.isEmpty() ? 0 : 1);
+}
+
+
+//============================================================================
+QList<QByteArray> CDockLayoutJournal::records() const
+{
+	d->flushPending();
+	return d->Records;
+}
+
+
+//============================================================================
+QByteArray CDockLayoutJournal::toByteArray() const
+{
+	d->flushPending();
+	QByteArray Result;
+	for (const auto& Record : d->Records)
+	{
+		Result += Record;
+		Result += '\n';
+	}
+	return Result;
+}
+
+
+//============================================================================
+void CDockLayoutJournal::clear()
+{
+	d->PendingTimer->stop();
+	d->PendingRecord.clear();
+	d->PendingKey.clear();
+	d->Records.clear();
+}
+
+
+//============================================================================
+bool CDockLayoutJournal::replay(const QByteArray& Journal)
+{
+	d->flushPending();
+	d->Replaying = true;
+	bool Result = true;
+	for (auto Record : Journal.split('\n'))
+	{
+		Record = Record.trimmed();
+		if (Record.isEmpty() || Record.startsWith('#'))
+		{
+			continue;
+		}
+
+		if (!d->replayRecord(Record))
+		{
+			ADS_PRINT("CDockLayoutJournal::replay: skipped " << Record);
+			Result = false;
+			continue;
+		}
+
+		// The replayed records are already stored by the application - so
+		// we do not write them to the device again
+		d->Records.append(Record);
+	}
+	d->Replaying = false;
+	return Result;
+}
+
+
+//============================================================================
+bool CDockLayoutJournal::isRecording() const
+{
+	return !d->Replaying && !d->SuspendCount && !d->DockManager->isRestoringState();
+}
+
+
+//============================================================================
+QByteArray CDockLayoutJournal::operationName(eOperation Operation)
+{
+	return (Operation >= 0 && Operation < OperationCount)
+		? QByteArray(OperationNames[Operation]) : QByteArray();
+}
+
+
+//============================================================================
+QByteArray CDockLayoutJournal::compact()
+{
+	d->CompactionScheduled = false;
+	clear();
+	auto Snapshot = d->DockManager->saveState();
+
+	// The journal file only contains the records since the last snapshot
+	QFileDevice* FileDevice = qobject_cast<QFileDevice*>(d->Device.data());
+	if (FileDevice && FileDevice->isWritable())
+	{
+		FileDevice->resize(0);
+		FileDevice->seek(0);
+	}
+
+	emit compacted(Snapshot);
+	return Snapshot;
+}
+
+
+//============================================================================
+CLayoutJournalScope::CLayoutJournalScope(CDockManager* DockManager)
+{
+	auto LayoutJournal = DockManager ? DockManager->layoutJournal() : nullptr;
+	if (LayoutJournal && LayoutJournal->isRecording())
+	{
+		Journal = LayoutJournal;
+		Journal->d->SuspendCount++;
+	}
+}
+
+
+//============================================================================
+CLayoutJournalScope::~CLayoutJournalScope()
+{
+	if (!Journal)
+	{
+		return;
+	}
+
+	Journal->d->SuspendCount--;
+	if (Invalid)
+	{
+		Journal->invalidate();
+	}
+	else if (Operation >= 0)
+	{
+		Journal->append(Operation, Arguments);
+	}
+}
+
+
+//============================================================================
+void CLayoutJournalScope::record(CDockLayoutJournal::eOperation Operation,
+	const QStringList& Arguments)
+{
+	this->Operation = Operation;
+	this->Arguments = Arguments;
+}
+
+
+//============================================================================
+QString CLayoutJournalScope::areaAnchor(CDockAreaWidget* DockArea, QWidget* Excluded)
+{
+	if (!DockArea || DockArea == Excluded)
+	{
+		return QString();
+	}
+
+	for (int i = 0; i < DockArea->dockWidgetsCount(); ++i)
+	{
+		auto DockWidget = DockArea->dockWidget(i);
+		if (DockWidget != Excluded)
+		{
+			return DockWidget->objectName();
+		}
+	}
+
+	return QString();
+}
+
+
+//============================================================================
+bool CLayoutJournalScope::targetArguments(DockWidgetArea Area,
+	CDockAreaWidget* TargetArea, CDockContainerWidget* TargetContainer,
+	QWidget* Excluded, QStringList& Arguments)
+{
+	Arguments.append(QString::number(Area));
+	if (TargetArea)
+	{
+		auto Anchor = areaAnchor(TargetArea, Excluded);
+		Arguments << Anchor << QString();
+		return !Anchor.isEmpty();
+	}
+
+	Arguments.append(QString());
+	if (!TargetContainer->isFloating())
+	{
+		// An empty container anchor identifies the dock manager
+		Arguments.append(QString());
+		return true;
+	}
+
+	for (int i = 0; i < TargetContainer->dockAreaCount(); ++i)
+	{
+		auto Anchor = areaAnchor(TargetContainer->dockArea(i), Excluded);
+		if (!Anchor.isEmpty())
+		{
+			Arguments.append(Anchor);
+			return true;
+		}
+	}
+
+	return false;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockLayoutJournal.cpp
@@ -0,0 +1,268 @@
+#ifndef DockLayoutJournalH
+#define DockLayoutJournalH
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockLayoutJournal.h
+/// \date   19.10.2026
+/// \brief  Declaration of CDockLayoutJournal class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QObject>
+#include <QStringList>
+#include <QByteArray>
+
+#include "ads_globals.h"
+
+class QIODevice;
+class QWidget;
+
+namespace ads
+{
+struct DockLayoutJournalPrivate;
+class CDockManager;
+class CDockWidget;
+class CDockAreaWidget;
+class CDockContainerWidget;
+class CLayoutJournalScope;
+
+/**
+ * Append-only journal of layout operations.
+ * If the journal is enabled via CDockManager::setLayoutJournalEnabled(),
+ * the dock manager records each layout mutation as a compact, single line
+ * text record. The records can be replayed on top of the last saved
+ * snapshot to reconstruct the current layout. Persisting a record after
+ * each user action is much cheaper than a complete saveState() and the
+ * journal can be used as audit trail to find out how a layout got into
+ * its current state.
+ * Dock widgets are identified by their object names - the same as in the
+ * saved state.
+ */
+class ADS_EXPORT CDockLayoutJournal : public QObject
+{
+	Q_OBJECT
+private:
+	DockLayoutJournalPrivate* d; ///< private data (pimpl)
+	friend struct DockLayoutJournalPrivate;
+	friend class CDockManager;
+	friend class CLayoutJournalScope;
+
+protected:
+	/**
+	 * Creates the journal for the given dock manager.
+	 * Use CDockManager::setLayoutJournalEnabled() to create the journal
+	 */
+	CDockLayoutJournal(CDockManager* DockManager);
+
+	/**
+	 * Appends the given operation record to the journal
+	 */
+	void append(int Operation, const QStringList& Arguments);
+
+	/**
+	 * Schedules a compaction because the last operation could not be
+	 * expressed as journal record
+	 */
+	void invalidate();
+
+public:
+	/**
+	 * The recorded layout operations
+	 */
+	enum eOperation
+	{
+		DockWidgetAdded,        ///< dock widget added via addDockWidget()
+		DockWidgetMoved,        ///< dock widget dropped into area or container
+		DockAreaMoved,          ///< complete dock area dropped into area or container
+		FloatingWidgetDropped,  ///< floating widget dropped into area or container
+		DockWidgetFloated,      ///< dock widget moved into new floating widget
+		DockAreaFloated,        ///< dock area moved into new floating widget
+		DockWidgetClosed,       ///< dock widget closed
+		DockWidgetOpened,       ///< dock widget opened
+		SplitterResized,        ///< splitter handle moved by the user
+		TabMoved,               ///< tab moved to a new index
+		CurrentTabChanged,      ///< current dock widget of dock area changed
+		FloatingGeometryChanged,///< floating widget moved or resized
+		DockWidgetRemoved,      ///< dock widget removed from dock manager
+		OperationCount
+	};
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CDockLayoutJournal();
+
+	/**
+	 * Each new record is appended as a single line to the given device.
+	 * The device needs to be open for writing and is not owned by the
+	 * journal. Use QIODevice::Append mode for files to keep the records
+	 * of previous sessions.
+	 */
+	void setDevice(QIODevice* Device);
+
+	/**
+	 * Returns the device set via setDevice()
+	 */
+	QIODevice* device() const;
+
+	/**
+	 * If the number of records reaches the given count, the journal is
+	 * automatically compacted into a new snapshot.
+	 * A value of 0 disables the automatic compaction.
+	 */
+	void setCompactionThreshold(int Count);
+
+	/**
+	 * Returns the compaction threshold
+	 */
+	int compactionThreshold() const;
+
+	/**
+	 * Returns the number of records since the last compaction
+	 */
+	int count() const;
+
+	/**
+	 * Returns all records since the last compaction
+	 */
+	QList<QByteArray> records() const;
+
+	/**
+	 * Returns all records since the last compaction as newline separated
+	 * text
+	 */
+	QByteArray toByteArray() const;
+
+	/**
+	 * Removes all records
+	 */
+	void clear();
+
+	/**
+	 * Replays the given journal on top of the current layout.
+	 * Usually you restore the last snapshot via CDockManager::restoreState()
+	 * and then replay the journal that has been recorded since this snapshot.
+	 * Records that refer to unknown dock widgets are skipped. The function
+	 * returns false, if one or more records have been skipped.
+	 */
+	bool replay(const QByteArray& Journal);
+
+	/**
+	 * Returns true, if the journal currently records operations.
+	 * Recording is suspended while the dock manager restores its state
+	 * and while a journal is replayed.
+	 */
+	bool isRecording() const;
+
+	/**
+	 * Returns the text that is used for the given operation in a record
+	 */
+	static QByteArray operationName(eOperation Operation);
+
+public slots:
+	/**
+	 * Saves the current state of the dock manager into a new snapshot,
+	 * clears all records and truncates a file device.
+	 * The function emits compacted() with the new snapshot.
+	 */
+	QByteArray compact();
+
+signals:
+	/**
+	 * This signal is emitted for each new record
+	 */
+	void recordAppended(const QByteArray& Record);
+
+	/**
+	 * This signal is emitted, if the journal has been compacted.
+	 * The application should persist the given snapshot - all following
+	 * records need to be replayed on top of this snapshot.
+	 */
+	void compacted(const QByteArray& Snapshot);
+}; // class CDockLayoutJournal
+
+
+/**
+ * Records a single layout operation into the journal of a dock manager.
+ * All records that nested function calls try to create while the scope
+ * object is alive are suppressed. So only the outermost operation, i.e. the
+ * user action, is recorded.
+ */
+class ADS_EXPORT CLayoutJournalScope
+{
+private:
+	CDockLayoutJournal* Journal = nullptr;
+	bool Invalid = false;
+	int Operation = -1;
+	QStringList Arguments;
+
+public:
+	/**
+	 * Opens a scope for the journal of the given dock manager
+	 */
+	CLayoutJournalScope(CDockManager* DockManager);
+
+	/**
+	 * Appends the operation given in record() to the journal
+	 */
+	~CLayoutJournalScope();
+
+	/**
+	 * Returns true, if the operation of this scope will be recorded.
+	 * Use this function to skip the creation of the record arguments if
+	 * journaling is disabled.
+	 */
+	bool isActive() const {return Journal != nullptr;}
+
+	/**
+	 * Sets the record that is appended when the scope is closed
+	 */
+	void record(CDockLayoutJournal::eOperation Operation, const QStringList& Arguments);
+
+	/**
+	 * Call this function, if the operation cannot be expressed as a
+	 * journal record. The journal will be compacted into a new snapshot
+	 */
+	void invalidate() {Invalid = true;}
+
+	/**
+	 * Returns the name that identifies the given dock area in a record.
+	 * This is the name of the first dock widget in the area that is not
+	 * the Excluded widget. Returns an empty string if there is no such
+	 * dock widget.
+	 */
+	static QString areaAnchor(CDockAreaWidget* DockArea, QWidget* Excluded = nullptr);
+
+	/**
+	 * Returns the arguments that describe a drop target.
+	 * If TargetArea is a nullptr, the target is the given TargetContainer.
+	 * Returns false, if the target can not be identified.
+	 */
+	static bool targetArguments(DockWidgetArea Area, CDockAreaWidget* TargetArea,
+		CDockContainerWidget* TargetContainer, QWidget* Excluded, QStringList& Arguments);
+};
+} // namespace ads
+
+//-----------------------------------------------------------------------------
+#endif // DockLayoutJournalH
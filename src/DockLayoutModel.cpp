@@ -0,0 +1,718 @@
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockLayoutModel.cpp
+/// \date   19.10.2026
+/// \brief  Implementation of CDockLayoutModel class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockLayoutModel.h"
+#include "DockStateStream.h"
+
+#include <QBuffer>
+#include <QSet>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#if QT_VERSION < 0x050900
+// Defined in DockContainerWidget.cpp
+QByteArray qByteArrayToHex(const QByteArray& src, char separator);
+#endif
+
+namespace ads
+{
+/**
+ * Private data class of CDockLayoutModel class (pimpl)
+ */
+struct DockLayoutModelPrivate
+{
+	CDockLayoutModel* _this;
+	int Version = Version1;
+	QVector<CDockLayoutModel::Container> Containers;
+	QVector<CDockLayoutModel::Node> Nodes;
+
+	/**
+	 * Private data constructor
+	 */
+	DockLayoutModelPrivate(CDockLayoutModel* _public);
+
+	/**
+	 * Parses the complete state the stream is positioned on
+	 */
+	bool readState(QXmlStreamReader& s);
+
+	/**
+	 * Parses a splitter or dock area element and returns the index of the
+	 * created node in CreatedNode
+	 */
+	bool readNode(QXmlStreamReader& s, int FileVersion, int& CreatedNode);
+
+	/**
+	 * Parses a splitter element including all its child nodes
+	 */
+	bool readSplitter(QXmlStreamReader& s, int FileVersion, int& CreatedNode);
+
+	/**
+	 * Parses a dock area element
+	 */
+	bool readDockArea(QXmlStreamReader& s, int& CreatedNode);
+
+	/**
+	 * Writes the node with the given index and all its child nodes
+	 */
+	void writeNode(QXmlStreamWriter& s, int NodeIndex) const;
+};
+// struct DockLayoutModelPrivate
+
+
+//============================================================================
+DockLayoutModelPrivate::DockLayoutModelPrivate(CDockLayoutModel* _public) :
+	_this(_public)
+{
+
+}
+
+
+//============================================================================
+bool CDockLayoutModel::Node::operator==(const Node& Other) const
+{
+	if (Type != Other.Type)
+	{
+		return false;
+	}
+
+	if (Type == SplitterNode)
+	{
+		return Orientation == Other.Orientation && Children == Other.Children
+			&& Sizes == Other.Sizes;
+	}
+	else
+	{
+		return CurrentDockWidget == Other.CurrentDockWidget
+			&& DockWidgets == Other.DockWidgets;
+	}
+}
+
+
+//============================================================================
+CDockLayoutModel::CDockLayoutModel() :
+	d(new DockLayoutModelPrivate(this))
+{
+
+}
+
+
+//============================================================================
+CDockLayoutModel::CDockLayoutModel(const CDockLayoutModel& Other) :
+	d(new DockLayoutModelPrivate(this))
+{
+	*this = Other;
+}
+
+
+//============================================================================
+CDockLayoutModel::~CDockLayoutModel()
+{
+	delete d;
+}
+
+
+//============================================================================
+CDockLayoutModel& CDockLayoutModel::operator=(const CDockLayoutModel& Other)
+{
+	d->Version = Other.d->Version;
+	d->Containers = Other.d->Containers;
+	d->Nodes = Other.d->Nodes;
+	return *this;
+}
+
+
+//============================================================================
+bool CDockLayoutModel::isEmpty() const
+{
+	return d->Containers.isEmpty();
+}
+
+
+//============================================================================
+int CDockLayoutModel::version() const
+{
+	return d->Version;
+}
+
+
+//============================================================================
+void CDockLayoutModel::setVersion(int Version)
+{
+	d->Version = Version;
+}
+
+
+//============================================================================
+int CDockLayoutModel::containerCount() const
+{
+	return d->Containers.count();
+}
+
+
+//============================================================================
+const CDockLayoutModel::Container& CDockLayoutModel::container(int Index) const
+{
+	return d->Containers[Index];
+}
+
+
+//============================================================================
+int CDockLayoutModel::nodeCount() const
+{
+	return d->Nodes.count();
+}
+
+
+//============================================================================
+const CDockLayoutModel::Node& CDockLayoutModel::node(int Index) const
+{
+	return d->Nodes[Index];
+}
+
+
+//============================================================================
+void CDockLayoutModel::clear()
+{
+	d->Containers.clear();
+	d->Nodes.clear();
+}
+
+
+//============================================================================
+int CDockLayoutModel::addContainer(bool Floating, const QByteArray& Geometry)
+{
+	Container NewContainer;
+	NewContainer.Floating = Floating;
+	NewContainer.Geometry = Geometry;
+	d->Containers.append(NewContainer);
+	return d->Containers.count() - 1;
+}
+
+
+//============================================================================
+int CDockLayoutModel::addSplitter(Qt::Orientation Orientation)
+{
+	Node NewNode;
+	NewNode.Type = SplitterNode;
+	NewNode.Orientation = Orientation;
+	d->Nodes.append(NewNode);
+	return d->Nodes.count() - 1;
+}
+
+
+//============================================================================
+int CDockLayoutModel::addDockArea(const QString& CurrentDockWidget)
+{
+	Node NewNode;
+	NewNode.Type = AreaNode;
+	NewNode.CurrentDockWidget = CurrentDockWidget;
+	d->Nodes.append(NewNode);
+	return d->Nodes.count() - 1;
+}
+
+
+//============================================================================
+void CDockLayoutModel::addDockWidget(int AreaIndex, const QString& Name, bool Closed)
+{
+	DockWidgetEntry Entry;
+	Entry.Name = Name;
+	Entry.Closed = Closed;
+	d->Nodes[AreaIndex].DockWidgets.append(Entry);
+}
+
+
+//============================================================================
+void CDockLayoutModel::setCurrentDockWidget(int AreaIndex, const QString& Name)
+{
+	d->Nodes[AreaIndex].CurrentDockWidget = Name;
+}
+
+
+//============================================================================
+void CDockLayoutModel::addChild(int SplitterIndex, int Child, int Size)
+{
+	d->Nodes[SplitterIndex].Children.append(Child);
+	d->Nodes[SplitterIndex].Sizes.append(Size);
+}
+
+
+//============================================================================
+void CDockLayoutModel::setRootNode(int ContainerIndex, int NodeIndex)
+{
+	d->Containers[ContainerIndex].RootNode = NodeIndex;
+}
+
+
+//============================================================================
+QVector<int> CDockLayoutModel::areaNodes(int ContainerIndex) const
+{
+	QVector<int> Result;
+	QVector<int> PendingNodes;
+	if (d->Containers[ContainerIndex].RootNode >= 0)
+	{
+		PendingNodes.append(d->Containers[ContainerIndex].RootNode);
+	}
+
+	while (!PendingNodes.isEmpty())
+	{
+		int NodeIndex = PendingNodes.takeLast();
+		const auto& Node = d->Nodes[NodeIndex];
+		if (Node.Type == AreaNode)
+		{
+			Result.append(NodeIndex);
+			continue;
+		}
+
+		// Push children in reverse order to visit them from left to right
+		for (int i = Node.Children.count() - 1; i >= 0; --i)
+		{
+			PendingNodes.append(Node.Children[i]);
+		}
+	}
+
+	return Result;
+}
+
+
+//============================================================================
+QStringList CDockLayoutModel::dockWidgetNames() const
+{
+	QStringList Result;
+	for (const auto& Node : d->Nodes)
+	{
+		for (const auto& Entry : Node.DockWidgets)
+		{
+			Result.append(Entry.Name);
+		}
+	}
+	return Result;
+}
+
+
+//============================================================================
+bool CDockLayoutModel::isValid() const
+{
+	if (d->Containers.isEmpty() || d->Containers.first().Floating)
+	{
+		return false;
+	}
+
+	QSet<int> UsedNodes;
+	QVector<int> PendingNodes;
+	for (const auto& Container : d->Containers)
+	{
+		if (Container.Floating && Container.Geometry.isEmpty())
+		{
+			return false;
+		}
+
+		if (Container.RootNode >= 0)
+		{
+			PendingNodes.append(Container.RootNode);
+		}
+	}
+
+	while (!PendingNodes.isEmpty())
+	{
+		int NodeIndex = PendingNodes.takeLast();
+		if (NodeIndex < 0 || NodeIndex >= d->Nodes.count() || UsedNodes.contains(NodeIndex))
+		{
+			return false;
+		}
+
+		UsedNodes.insert(NodeIndex);
+		const auto& Node = d->Nodes[NodeIndex];
+		if (Node.Type == SplitterNode)
+		{
+			if (Node.Sizes.count() != Node.Children.count())
+			{
+				return false;
+			}
+			PendingNodes += Node.Children;
+		}
+		else
+		{
+			for (const auto& Entry : Node.DockWidgets)
+			{
+				if (Entry.Name.isEmpty())
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+bool CDockLayoutModel::fromXml(const QByteArray& State)
+{
+	clear();
+	if (CCompressedStateReader::isCompressedState(State))
+	{
+		QBuffer Buffer(const_cast<QByteArray*>(&State));
+		Buffer.open(QIODevice::ReadOnly);
+		return fromXml(&Buffer);
+	}
+
+	QByteArray state = State.startsWith("<?xml") ? State : qUncompress(State);
+	if (state.isEmpty())
+	{
+		return false;
+	}
+
+	QXmlStreamReader s(state);
+	return d->readState(s);
+}
+
+
+//============================================================================
+bool CDockLayoutModel::fromXml(QIODevice* Device)
+{
+	clear();
+	if (CCompressedStateReader::isCompressedState(Device))
+	{
+		CCompressedStateReader Reader(Device);
+		QXmlStreamReader s(&Reader);
+		if (!d->readState(s) || Reader.hasError())
+		{
+			clear();
+			return false;
+		}
+		return true;
+	}
+
+	// A state compressed via qCompress() can only be uncompressed as a whole
+	if (!Device->peek(5).startsWith("<?xml"))
+	{
+		return fromXml(Device->readAll());
+	}
+
+	QXmlStreamReader s(Device);
+	return d->readState(s);
+}
+
+
+//============================================================================
+bool DockLayoutModelPrivate::readState(QXmlStreamReader& s)
+{
+	s.readNextStartElement();
+	if (s.name() != "QtAdvancedDockingSystem")
+	{
+		return false;
+	}
+
+	bool Ok;
+	int FileVersion = s.attributes().value("Version").toInt(&Ok);
+	if (!Ok || FileVersion > CurrentVersion)
+	{
+		return false;
+	}
+
+	Version = FileVersion;
+	while (s.readNextStartElement())
+	{
+		if (s.name() != "Container")
+		{
+			continue;
+		}
+
+		if (!_this->readContainer(s, FileVersion))
+		{
+			_this->clear();
+			return false;
+		}
+	}
+
+	// A truncated state must not be restored partially
+	if (s.hasError())
+	{
+		_this->clear();
+		return false;
+	}
+
+	return true;
+}
+
+
+//============================================================================
+bool CDockLayoutModel::readContainer(QXmlStreamReader& s, int FileVersion)
+{
+	int ContainerIndex = addContainer(s.attributes().value("Floating").toInt());
+	if (d->Containers[ContainerIndex].Floating)
+	{
+		if (!s.readNextStartElement() || s.name() != "Geometry")
+		{
+			return false;
+		}
+
+		QByteArray GeometryString = s.readElementText(QXmlStreamReader::ErrorOnUnexpectedElement).toLocal8Bit();
+		d->Containers[ContainerIndex].Geometry = QByteArray::fromHex(GeometryString);
+		if (d->Containers[ContainerIndex].Geometry.isEmpty())
+		{
+			return false;
+		}
+	}
+
+	// If the saved state contains multiple top level nodes, the last one
+	// becomes the root node - this mirrors the behavior of the widget
+	// based restore
+	while (s.readNextStartElement())
+	{
+		int CreatedNode = -1;
+		if (!d->readNode(s, FileVersion, CreatedNode))
+		{
+			return false;
+		}
+
+		if (CreatedNode >= 0)
+		{
+			d->Containers[ContainerIndex].RootNode = CreatedNode;
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+bool DockLayoutModelPrivate::readNode(QXmlStreamReader& s, int FileVersion, int& CreatedNode)
+{
+	if (s.name() == "Splitter")
+	{
+		return readSplitter(s, FileVersion, CreatedNode);
+	}
+	else if (s.name() == "Area")
+	{
+		return readDockArea(s, CreatedNode);
+	}
+	else
+	{
+		s.skipCurrentElement();
+		return true;
+	}
+}
+
+
+//============================================================================
+bool DockLayoutModelPrivate::readSplitter(QXmlStreamReader& s, int FileVersion,
+	int& CreatedNode)
+{
+	bool Ok;
+	QString OrientationStr = s.attributes().value("Orientation").toString();
+
+	// Check if the orientation string is right
+	if (!OrientationStr.startsWith("|") && !OrientationStr.startsWith("-"))
+	{
+		return false;
+	}
+
+	// The "|" shall indicate a vertical splitter handle which in turn means
+	// a Horizontal orientation of the splitter layout.
+	bool HorizontalSplitter = OrientationStr.startsWith("|");
+	// In version 0 we had a small bug. The "|" indicated a vertical orientation,
+	// but this is wrong, because only the splitter handle is vertical, the
+	// layout of the splitter is a horizontal layout. We fix this here
+	if (FileVersion == 0)
+	{
+		HorizontalSplitter = !HorizontalSplitter;
+	}
+
+	int WidgetCount = s.attributes().value("Count").toInt(&Ok);
+	if (!Ok)
+	{
+		return false;
+	}
+
+	int SplitterIndex = _this->addSplitter(HorizontalSplitter ? Qt::Horizontal : Qt::Vertical);
+	QList<int> Sizes;
+	while (s.readNextStartElement())
+	{
+		if (s.name() == "Sizes")
+		{
+			QString sSizes = s.readElementText().trimmed();
+			QTextStream TextStream(&sSizes);
+			while (!TextStream.atEnd())
+			{
+				int value;
+				TextStream >> value;
+				Sizes.append(value);
+			}
+			continue;
+		}
+
+		int ChildNode = -1;
+		if (!readNode(s, FileVersion, ChildNode))
+		{
+			return false;
+		}
+
+		if (ChildNode >= 0)
+		{
+			Nodes[SplitterIndex].Children.append(ChildNode);
+		}
+	}
+
+	if (Sizes.count() != WidgetCount)
+	{
+		return false;
+	}
+
+	Nodes[SplitterIndex].Sizes = Sizes;
+	CreatedNode = SplitterIndex;
+	return true;
+}
+
+
+//============================================================================
+bool DockLayoutModelPrivate::readDockArea(QXmlStreamReader& s, int& CreatedNode)
+{
+	bool Ok;
+	int AreaIndex = _this->addDockArea(s.attributes().value("Current").toString());
+	while (s.readNextStartElement())
+	{
+		if (s.name() != "Widget")
+		{
+			continue;
+		}
+
+		auto ObjectName = s.attributes().value("Name");
+		if (ObjectName.isEmpty())
+		{
+			return false;
+		}
+
+		bool Closed = s.attributes().value("Closed").toInt(&Ok);
+		if (!Ok)
+		{
+			return false;
+		}
+
+		s.skipCurrentElement();
+		_this->addDockWidget(AreaIndex, ObjectName.toString(), Closed);
+	}
+
+	CreatedNode = AreaIndex;
+	return true;
+}
+
+
+//============================================================================
+QByteArray CDockLayoutModel::toXml(bool AutoFormatting) const
+{
+	QByteArray xmldata;
+	QXmlStreamWriter s(&xmldata);
+	s.setAutoFormatting(AutoFormatting);
+	s.writeStartDocument();
+		s.writeStartElement("QtAdvancedDockingSystem");
+		s.writeAttribute("Version", QString::number(d->Version));
+		s.writeAttribute("Containers", QString::number(d->Containers.count()));
+		for (const auto& Container : d->Containers)
+		{
+			s.writeStartElement("Container");
+			s.writeAttribute("Floating", QString::number(Container.Floating ? 1 : 0));
+			if (Container.Floating)
+			{
+#if QT_VERSION < 0x050900
+				s.writeTextElement("Geometry", qByteArrayToHex(Container.Geometry, ' '));
+#else
+				s.writeTextElement("Geometry", Container.Geometry.toHex(' '));
+#endif
+			}
+			if (Container.RootNode >= 0)
+			{
+				d->writeNode(s, Container.RootNode);
+			}
+			s.writeEndElement();
+		}
+		s.writeEndElement();
+	s.writeEndDocument();
+	return xmldata;
+}
+
+
+//============================================================================
+void DockLayoutModelPrivate::writeNode(QXmlStreamWriter& s, int NodeIndex) const
+{
+	const auto& Node = Nodes[NodeIndex];
+	if (Node.Type == CDockLayoutModel::SplitterNode)
+	{
+		// Version 0 files use the inverted orientation - see readSplitter()
+		bool HorizontalSplitter = (Node.Orientation == Qt::Horizontal);
+		if (Version == 0)
+		{
+			HorizontalSplitter = !HorizontalSplitter;
+		}
+		s.writeStartElement("Splitter");
+		s.writeAttribute("Orientation", HorizontalSplitter ? "|" : "-");
+		s.writeAttribute("Count", QString::number(Node.Sizes.count()));
+			for (auto Child : Node.Children)
+			{
+				writeNode(s, Child);
+			}
+
+			s.writeStartElement("Sizes");
+			for (auto Size : Node.Sizes)
+			{
+				s.writeCharacters(QString::number(Size) + " ");
+			}
+			s.writeEndElement();
+		s.writeEndElement();
+	}
+	else
+	{
+		s.writeStartElement("Area");
+		s.writeAttribute("Tabs", QString::number(Node.DockWidgets.count()));
+		s.writeAttribute("Current", Node.CurrentDockWidget);
+		for (const auto& Entry : Node.DockWidgets)
+		{
+			s.writeStartElement("Widget");
+			s.writeAttribute("Name", Entry.Name);
+			s.writeAttribute("Closed", QString::number(Entry.Closed ? 1 : 0));
+			s.writeEndElement();
+		}
+		s.writeEndElement();
+	}
+}
+
+
+//============================================================================
+bool CDockLayoutModel::operator==(const CDockLayoutModel& Other) const
+{
+	return d->Version == Other.d->Version && d->Containers == Other.d->Containers
+		&& d->Nodes == Other.d->Nodes;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockLayoutModel.cpp
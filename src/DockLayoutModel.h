@@ -0,0 +1,270 @@
+#ifndef DockLayoutModelH
+#define DockLayoutModelH
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockLayoutModel.h
+/// \date   19.10.2026
+/// \brief  Declaration of CDockLayoutModel class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "ads_globals.h"
+
+class QIODevice;
+class QXmlStreamReader;
+
+namespace ads
+{
+struct DockLayoutModelPrivate;
+
+/**
+ * Widget free model of a complete docking layout.
+ * The model contains the tree of all dock containers with their splitters,
+ * the splitter orientations and sizes and the dock areas with their dock
+ * widget tabs. It does not reference any widget - dock widgets are
+ * identified by their object names like in the saved state. So the model
+ * can be parsed, validated, compared and serialized without creating
+ * any widget. The dock manager realizes a model via
+ * CDockManager::restoreState(const CDockLayoutModel&) and returns the model
+ * of the current layout via CDockManager::layoutModel().
+ * The nodes of all containers are stored in a single flat node list and
+ * splitter nodes reference their child nodes by index.
+ */
+class ADS_EXPORT CDockLayoutModel
+{
+public:
+	enum eNodeType
+	{
+		SplitterNode,
+		AreaNode
+	};
+
+	/**
+	 * A single dock widget tab in a dock area node
+	 */
+	struct DockWidgetEntry
+	{
+		QString Name;
+		bool Closed = false;
+
+		bool operator==(const DockWidgetEntry& Other) const
+		{
+			return Name == Other.Name && Closed == Other.Closed;
+		}
+	};
+
+	/**
+	 * Splitter node or dock area node
+	 */
+	struct Node
+	{
+		eNodeType Type = AreaNode;
+		Qt::Orientation Orientation = Qt::Horizontal; ///< splitter nodes only
+		QVector<int> Children; ///< node indices, splitter nodes only
+		QList<int> Sizes; ///< splitter nodes only
+		QString CurrentDockWidget; ///< dock area nodes only
+		QVector<DockWidgetEntry> DockWidgets; ///< dock area nodes only
+
+		bool operator==(const Node& Other) const;
+	};
+
+	/**
+	 * The main dock container or a floating dock container
+	 */
+	struct Container
+	{
+		bool Floating = false;
+		QByteArray Geometry; ///< saved floating widget geometry
+		int RootNode = -1; ///< index of root node or -1 for empty containers
+
+		bool operator==(const Container& Other) const
+		{
+			return Floating == Other.Floating && Geometry == Other.Geometry
+				&& RootNode == Other.RootNode;
+		}
+	};
+
+private:
+	DockLayoutModelPrivate* d; ///< private data (pimpl)
+	friend struct DockLayoutModelPrivate;
+
+public:
+	/**
+	 * Creates an empty model
+	 */
+	CDockLayoutModel();
+
+	/**
+	 * Copy constructor
+	 */
+	CDockLayoutModel(const CDockLayoutModel& Other);
+
+	/**
+	 * Destructor
+	 */
+	~CDockLayoutModel();
+
+	/**
+	 * Assignment operator
+	 */
+	CDockLayoutModel& operator=(const CDockLayoutModel& Other);
+
+	/**
+	 * Returns true, if the model does not contain any container
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * Removes all containers and nodes
+	 */
+	void clear();
+
+	/**
+	 * The file version that is written into the serialized state
+	 */
+	int version() const;
+
+	/**
+	 * Sets the file version
+	 */
+	void setVersion(int Version);
+
+	/**
+	 * Returns the number of containers. The first container is the
+	 * dock manager, all other containers are floating containers
+	 */
+	int containerCount() const;
+
+	/**
+	 * Returns the container with the given index
+	 */
+	const Container& container(int Index) const;
+
+	/**
+	 * Returns the number of nodes of all containers
+	 */
+	int nodeCount() const;
+
+	/**
+	 * Returns the node with the given index
+	 */
+	const Node& node(int Index) const;
+
+	/**
+	 * Appends a new container and returns its index
+	 */
+	int addContainer(bool Floating = false, const QByteArray& Geometry = QByteArray());
+
+	/**
+	 * Appends a new splitter node and returns its index.
+	 * Use addChild() to add child nodes and setRootNode() to assign the
+	 * node to a container.
+	 */
+	int addSplitter(Qt::Orientation Orientation);
+
+	/**
+	 * Appends a new dock area node and returns its index
+	 */
+	int addDockArea(const QString& CurrentDockWidget = QString());
+
+	/**
+	 * Appends a dock widget tab to the given dock area node
+	 */
+	void addDockWidget(int AreaIndex, const QString& Name, bool Closed = false);
+
+	/**
+	 * Sets the current dock widget of the given dock area node
+	 */
+	void setCurrentDockWidget(int AreaIndex, const QString& Name);
+
+	/**
+	 * Appends the node Child with the given size to the splitter node
+	 */
+	void addChild(int SplitterIndex, int Child, int Size);
+
+	/**
+	 * Sets the root node of the given container
+	 */
+	void setRootNode(int ContainerIndex, int NodeIndex);
+
+	/**
+	 * Returns the indices of all dock area nodes of the given container in
+	 * the order they appear in the layout
+	 */
+	QVector<int> areaNodes(int ContainerIndex) const;
+
+	/**
+	 * Returns the names of all dock widgets in the model
+	 */
+	QStringList dockWidgetNames() const;
+
+	/**
+	 * Returns true, if the model describes a layout that can be realized.
+	 * The first container needs to be the non floating dock manager
+	 * container, floating containers need a geometry, all node indices
+	 * need to be valid, each node may only be used once and the
+	 * number of sizes of a splitter needs to match its child count.
+	 */
+	bool isValid() const;
+
+	/**
+	 * Parses the given saved state into this model. The state may be
+	 * compressed. Returns false and leaves an empty model, if the state
+	 * is not a valid docking state.
+	 */
+	bool fromXml(const QByteArray& State);
+
+	/**
+	 * Parses the saved state from the given device that needs to be open
+	 * for reading. Plain XML states and states written by
+	 * CCompressedStateWriter are parsed incrementally without reading the
+	 * complete state into memory.
+	 */
+	bool fromXml(QIODevice* Device);
+
+	/**
+	 * Parses the Container element the stream is positioned on and
+	 * appends the container to this model
+	 */
+	bool readContainer(QXmlStreamReader& Stream, int FileVersion);
+
+	/**
+	 * Serializes the model into the saved state format of
+	 * CDockManager::saveState()
+	 */
+	QByteArray toXml(bool AutoFormatting = false) const;
+
+	bool operator==(const CDockLayoutModel& Other) const;
+	bool operator!=(const CDockLayoutModel& Other) const {return !(*this == Other);}
+}; // class CDockLayoutModel
+} // namespace ads
+
+//-----------------------------------------------------------------------------
+#endif // DockLayoutModelH
@@ -45,20 +45,109 @@
 #include <QSettings>
 #include <QMenu>
 #include <QApplication>
+#include <QTimer>
+#include <QPointer>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QRegion>
 
 #include "FloatingDockContainer.h"
 #include "DockOverlay.h"
 #include "DockWidget.h"
 #include "ads_globals.h"
 #include "DockAreaWidget.h"
+#include "DockAreaTitleBar.h"
+#include "DockAreaTabBar.h"
 #include "IconProvider.h"
-#include "DockingStateReader.h"
+#include "DockLayoutModel.h"
+#include "DockLayoutJournal.h"
+#include "DockStateStream.h"
+#include "DockWidgetProfiler.h"
 
 
 
 namespace ads
 {
 static CDockManager::ConfigFlags StaticConfigFlags = CDockManager::DefaultConfig;
+static qreal StaticDragPreviewScaleFactor = 0.5;
+static bool StaticApplicationStyleSheetInstalled = false;
+
+/**
+ * Swallows all user input events for the dock manager and its floating
+ * widgets while an asynchronous restore is running, so that the user cannot
+ * modify the layout before it is completely restored. The input of all
+ * other windows of the application is not blocked.
+ */
+class CRestoreInputBlocker : public QObject
+{
+private:
+	CDockManager* DockManager;
+
+	/**
+	 * Returns true, if the given receiver belongs to the dock manager or to
+	 * one of its floating widgets
+	 */
+	bool isDockingReceiver(QObject* Watched) const
+	{
+		// Shortcut events are delivered to the QShortcut or QAction objects
+		// so we check the widget they belong to
+		QObject* Object = Watched;
+		while (Object && !Object->isWidgetType())
+		{
+			Object = Object->parent();
+		}
+
+		auto Widget = static_cast<QWidget*>(Object);
+		if (!Widget)
+		{
+			return false;
+		}
+
+		if (Widget == DockManager || DockManager->isAncestorOf(Widget))
+		{
+			return true;
+		}
+
+		for (auto FloatingWidget : DockManager->floatingWidgets())
+		{
+			if (Widget == FloatingWidget || FloatingWidget->isAncestorOf(Widget))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	CRestoreInputBlocker(CDockManager* parent)
+		: QObject(parent), DockManager(parent)
+	{}
+
+	virtual bool eventFilter(QObject* Watched, QEvent* Event) override
+	{
+		switch (Event->type())
+		{
+		case QEvent::MouseButtonPress:
+		case QEvent::MouseButtonRelease:
+		case QEvent::MouseButtonDblClick:
+		case QEvent::MouseMove:
+		case QEvent::Wheel:
+		case QEvent::KeyPress:
+		case QEvent::KeyRelease:
+		case QEvent::Shortcut:
+		case QEvent::ShortcutOverride:
+		case QEvent::ContextMenu:
+		case QEvent::TouchBegin:
+		case QEvent::TouchUpdate:
+		case QEvent::TouchEnd:
+			return isDockingReceiver(Watched);
+
+		default:
+			return QObject::eventFilter(Watched, Event);
+		}
+	}
+};
 
 /**
  * Private data class of CDockManager class (pimpl)
@@ -77,6 +166,23 @@ struct DockManagerPrivate
 	CDockManager::eViewMenuInsertionOrder MenuInsertionOrder = CDockManager::MenuAlphabeticallySorted;
 	bool RestoringState = false;
 	QVector<CFloatingDockContainer*> UninitializedFloatingWidgets;
+	QTimer* AutoSaveTimer = nullptr;
+	QString AutoSaveFilePath;
+	QPointer<QIODevice> AutoSaveDevice;
+	QByteArray AutoSaveHash;
+	bool LayoutDirty = false;
+	CDockLayoutJournal* LayoutJournal = nullptr;
+	CDockWidgetProfiler* Profiler = nullptr;
+	bool OcclusionUpdatePending = false;
+	bool HiddenBeforeRestore = false;
+	CDockLayoutModel AsyncRestoreModel;
+	QVector<QPair<int, int>> PendingRestoreAreas; ///< container index and area node
+	int RestoredAreaCount = 0;
+	QHash<int, CDockAreaWidget*> PrebuiltDockAreas;
+	int RestoreTimeSlice = CDockManager::DefaultRestoreTimeSlice;
+	CRestoreInputBlocker* RestoreInputBlocker = nullptr;
+	QList<QPointer<CDockWidget>> DeferredRemovals; ///< removed while restoring
+	int StateCompressionLevel = CDockManager::BestStateCompression;
 
 	/**
 	 * Private data constructor
@@ -84,25 +190,74 @@ struct DockManagerPrivate
 	DockManagerPrivate(CDockManager* _public);
 
 	/**
-	 * Checks if the given data stream is a valid docking system state
-	 * file.
+	 * Emits restoringState() and stateRestored() for a state that could not
+	 * be restored. Listeners rely on the pair of signals for each
+	 * restoreState() call.
+	 */
+	void emitRestoreFailed()
+	{
+		RestoringState = true;
+		emit _this->restoringState();
+		RestoringState = false;
+		emit _this->stateRestored();
+	}
+
+	/**
+	 * Connects the layout change signals of the given container to
+	 * markLayoutDirty()
+	 */
+	void trackLayoutChanges(CDockContainerWidget* Container);
+
+	/**
+	 * Connects the layout change signals of the given dock widget to
+	 * markLayoutDirty()
+	 */
+	void trackLayoutChanges(CDockWidget* DockWidget);
+
+	/**
+	 * Creates the auto save timer with the given debounce delay
+	 */
+	void setupAutoSaveTimer(int DelayMs);
+
+	/**
+	 * Writes the given state to the auto save file or device
 	 */
-	bool checkFormat(const QByteArray &state, int version);
+	bool writeAutoSaveState(const QByteArray& State);
 
 	/**
-	 * Restores the state
+	 * Hides the dock manager and all floating widgets and prepares all dock
+	 * widgets for restoring a new state
 	 */
-	bool restoreStateFromXml(const QByteArray &state, int version, bool Testing = internal::Restore);
+	void beginRestoreState();
 
 	/**
-	 * Restore state
+	 * Deletes the floating widgets that are not used by the restored state,
+	 * restores the open state of all dock widgets and shows the restored
+	 * layout
 	 */
-	bool restoreState(const QByteArray &state, int version);
+	void finishRestoreState(int ContainerCount);
+
+	/**
+	 * Creates the next dock areas of an asynchronous restore until the time
+	 * slice is used up and realizes the containers when all dock areas have
+	 * been created
+	 */
+	void restoreNextSlice();
 
 	void restoreDockWidgetsOpenState();
 	void restoreDockAreasIndices();
 	void emitTopLevelEvents();
 
+	/**
+	 * Writes the state of all containers into the given stream
+	 */
+	void writeState(QXmlStreamWriter& s, int Version) const;
+
+	/**
+	 * Updates the occluded flag of the dock areas of all containers
+	 */
+	void updateOcclusion();
+
 	void hideFloatingWidgets()
 	{
 		// Hide updates of floating widgets from user
@@ -116,14 +271,15 @@ struct DockManagerPrivate
 	{
 		for (auto DockWidget : DockWidgetsMap)
 		{
-			DockWidget->setProperty("dirty", true);
+			DockWidget->setRestoreState(true, false);
 		}
 	}
 
 	/**
-	 * Restores the container with the given index
+	 * Restores the container with the given index from the layout model
 	 */
-	bool restoreContainer(int Index, CDockingStateReader& stream, bool Testing);
+	void restoreContainer(int Index, const CDockLayoutModel& Model,
+		const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas = QHash<int, CDockAreaWidget*>());
 
 	/**
 	 * Loads the stylesheet
@@ -146,116 +302,116 @@ DockManagerPrivate::DockManagerPrivate(CDockManager* _public) :
 
 
 //============================================================================
-void DockManagerPrivate::loadStylesheet()
+void DockManagerPrivate::trackLayoutChanges(CDockContainerWidget* Container)
 {
-	QString Result;
-#ifdef Q_OS_LINUX
-    QFile StyleSheetFile(":ads/stylesheets/default_linux.css");
-#else
-	QFile StyleSheetFile(":ads/stylesheets/default.css");
-#endif
-	StyleSheetFile.open(QIODevice::ReadOnly);
-	QTextStream StyleSheetStream(&StyleSheetFile);
-	Result = StyleSheetStream.readAll();
-	StyleSheetFile.close();
-	_this->setStyleSheet(Result);
+	QObject::connect(Container, &CDockContainerWidget::dockAreasAdded,
+		_this, &CDockManager::markLayoutDirty);
+	QObject::connect(Container, &CDockContainerWidget::dockAreasRemoved,
+		_this, &CDockManager::markLayoutDirty);
+	QObject::connect(Container, &CDockContainerWidget::dockAreaViewToggled,
+		_this, &CDockManager::markLayoutDirty);
 }
 
 
 //============================================================================
-bool DockManagerPrivate::restoreContainer(int Index, CDockingStateReader& stream, bool Testing)
+void DockManagerPrivate::trackLayoutChanges(CDockWidget* DockWidget)
 {
-	if (Testing)
-	{
-		Index = 0;
-	}
+	QObject::connect(DockWidget, &CDockWidget::viewToggled,
+		_this, &CDockManager::markLayoutDirty, Qt::UniqueConnection);
+}
 
-	bool Result = false;
-	if (Index >= Containers.count())
+
+//============================================================================
+void DockManagerPrivate::setupAutoSaveTimer(int DelayMs)
+{
+	if (!AutoSaveTimer)
 	{
-		CFloatingDockContainer* FloatingWidget = new CFloatingDockContainer(_this);
-		Result = FloatingWidget->restoreState(stream, Testing);
+		AutoSaveTimer = new QTimer(_this);
+		AutoSaveTimer->setSingleShot(true);
+		QObject::connect(AutoSaveTimer, &QTimer::timeout, _this, &CDockManager::autoSaveNow);
 	}
-	else
+	AutoSaveTimer->setInterval(DelayMs);
+	AutoSaveHash.clear();
+	LayoutDirty = true;
+	AutoSaveTimer->start();
+}
+
+
+//============================================================================
+bool DockManagerPrivate::writeAutoSaveState(const QByteArray& State)
+{
+	if (!AutoSaveFilePath.isEmpty())
 	{
-        ADS_PRINT("d->Containers[i]->restoreState ");
-		auto Container = Containers[Index];
-		if (Container->isFloating())
-		{
-			Result = Container->floatingWidget()->restoreState(stream, Testing);
-		}
-		else
+		QSaveFile File(AutoSaveFilePath);
+		if (!File.open(QIODevice::WriteOnly))
 		{
-			Result = Container->restoreState(stream, Testing);
+			return false;
 		}
+		File.write(State);
+		return File.commit();
 	}
 
-	return Result;
+	if (!AutoSaveDevice || !AutoSaveDevice->isWritable())
+	{
+		return false;
+	}
+
+	if (!AutoSaveDevice->isSequential() && !AutoSaveDevice->seek(0))
+	{
+		return false;
+	}
+
+	if (AutoSaveDevice->write(State) != State.size())
+	{
+		return false;
+	}
+
+	// Drop the remains of a previous, longer state
+	QFileDevice* FileDevice = qobject_cast<QFileDevice*>(AutoSaveDevice.data());
+	if (FileDevice)
+	{
+		FileDevice->resize(State.size());
+		FileDevice->flush();
+	}
+	return true;
 }
 
 
 //============================================================================
-bool DockManagerPrivate::checkFormat(const QByteArray &state, int version)
+void DockManagerPrivate::loadStylesheet()
 {
-    return restoreStateFromXml(state, version, internal::RestoreTesting);
+	// The application stylesheet already styles this manager
+	if (StaticApplicationStyleSheetInstalled)
+	{
+		return;
+	}
+
+	_this->setStyleSheet(CDockManager::defaultStyleSheet());
 }
 
 
 //============================================================================
-bool DockManagerPrivate::restoreStateFromXml(const QByteArray &state,  int version,
-	bool Testing)
+void DockManagerPrivate::restoreContainer(int Index, const CDockLayoutModel& Model,
+	const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas)
 {
-    if (state.isEmpty())
-    {
-        return false;
-    }
-    CDockingStateReader s(state);
-    s.readNextStartElement();
-    if (s.name() != "QtAdvancedDockingSystem")
-    {
-    	return false;
-    }
-    ADS_PRINT(s.attributes().value("Version"));
-    bool ok;
-    int v = s.attributes().value("Version").toInt(&ok);
-    if (!ok || v > CurrentVersion)
-    {
-    	return false;
-    }
-
-    s.setFileVersion(v);
-    bool Result = true;
-#ifdef ADS_DEBUG_PRINT
-    int  DockContainers = s.attributes().value("Containers").toInt();
-#endif
-    ADS_PRINT(DockContainers);
-    int DockContainerCount = 0;
-    while (s.readNextStartElement())
-    {
-    	if (s.name() == "Container")
-    	{
-    		Result = restoreContainer(DockContainerCount, s, Testing);
-			if (!Result)
-			{
-				break;
-			}
-			DockContainerCount++;
-    	}
-    }
-
-    if (!Testing)
-    {
-		// Delete remaining empty floating widgets
-		int FloatingWidgetIndex = DockContainerCount - 1;
-		int DeleteCount = FloatingWidgets.count() - FloatingWidgetIndex;
-		for (int i = 0; i < DeleteCount; ++i)
+	if (Index >= Containers.count())
+	{
+		CFloatingDockContainer* FloatingWidget = new CFloatingDockContainer(_this);
+		FloatingWidget->restoreState(Model, Index, PrebuiltDockAreas);
+	}
+	else
+	{
+        ADS_PRINT("d->Containers[i]->restoreState ");
+		auto Container = Containers[Index];
+		if (Container->isFloating())
 		{
-			FloatingWidgets[FloatingWidgetIndex + i]->deleteLater();
-			_this->removeDockContainer(FloatingWidgets[FloatingWidgetIndex + i]->dockContainer());
+			Container->floatingWidget()->restoreState(Model, Index, PrebuiltDockAreas);
 		}
-    }
-
-    return Result;
+		else
+		{
+			Container->restoreState(Model, Index, PrebuiltDockAreas);
+		}
+	}
 }
 
 
@@ -268,14 +424,14 @@ void DockManagerPrivate::restoreDockWidgetsOpenState()
     // toggle view action the next time
     for (auto DockWidget : DockWidgetsMap)
     {
-    	if (DockWidget->property(internal::DirtyProperty).toBool())
+    	if (DockWidget->isRestoreDirty())
     	{
     		DockWidget->flagAsUnassigned();
             emit DockWidget->viewToggled(false);
     	}
     	else
     	{
-    		DockWidget->toggleViewInternal(!DockWidget->property(internal::ClosedProperty).toBool());
+    		DockWidget->toggleViewInternal(!DockWidget->restoredClosedState());
     	}
     }
 }
@@ -294,7 +450,7 @@ void DockManagerPrivate::restoreDockAreasIndices()
     	for (int i = 0; i < DockContainer->dockAreaCount(); ++i)
     	{
     		CDockAreaWidget* DockArea = DockContainer->dockArea(i);
-    		QString DockWidgetName = DockArea->property("currentDockWidget").toString();
+    		QString DockWidgetName = DockArea->restoredCurrentDockWidgetName();
     		CDockWidget* DockWidget = nullptr;
     		if (!DockWidgetName.isEmpty())
     		{
@@ -348,30 +504,111 @@ void DockManagerPrivate::emitTopLevelEvents()
 
 
 //============================================================================
-bool DockManagerPrivate::restoreState(const QByteArray& State, int version)
+void DockManagerPrivate::beginRestoreState()
 {
-	QByteArray state = State.startsWith("<?xml") ? State : qUncompress(State);
-    if (!checkFormat(state, version))
-    {
-        ADS_PRINT("checkFormat: Error checking format!!!!!!!");
-    	return false;
-    }
+	// We hide the complete dock manager here. Restoring the state means
+	// that DockWidgets are removed from the DockArea internal stack layout
+	// which in turn  means, that each time a widget is removed the stack
+	// will show and raise the next available widget which in turn
+	// triggers show events for the dock widgets. To avoid this we hide the
+	// dock manager. The user will not see this hiding because the manager is
+	// shown again before the event loop runs for a synchronous restore. An
+	// asynchronous restore keeps it hidden until the layout is complete
+	HiddenBeforeRestore = _this->isHidden();
+	if (!HiddenBeforeRestore)
+	{
+		_this->hide();
+	}
+	RestoringState = true;
+	emit _this->restoringState();
 
     // Hide updates of floating widgets from use
     hideFloatingWidgets();
     markDockWidgetsDirty();
+}
 
-    if (!restoreStateFromXml(state, version))
-    {
-        ADS_PRINT("restoreState: Error restoring state!!!!!!!");
-    	return false;
-    }
+
+//============================================================================
+void DockManagerPrivate::finishRestoreState(int ContainerCount)
+{
+	// Delete remaining empty floating widgets
+	int FloatingWidgetIndex = ContainerCount - 1;
+	int DeleteCount = FloatingWidgets.count() - FloatingWidgetIndex;
+	for (int i = 0; i < DeleteCount; ++i)
+	{
+		FloatingWidgets[FloatingWidgetIndex + i]->deleteLater();
+		_this->removeDockContainer(FloatingWidgets[FloatingWidgetIndex + i]->dockContainer());
+	}
 
     restoreDockWidgetsOpenState();
     restoreDockAreasIndices();
     emitTopLevelEvents();
 
-    return true;
+	RestoringState = false;
+	_this->scheduleOcclusionUpdate();
+
+	// Remove the dock widgets the application removed during the restore
+	auto Removals = DeferredRemovals;
+	DeferredRemovals.clear();
+	for (auto DockWidget : Removals)
+	{
+		if (DockWidget)
+		{
+			_this->removeDockWidget(DockWidget);
+		}
+	}
+	emit _this->stateRestored();
+	if (!HiddenBeforeRestore)
+	{
+		_this->show();
+	}
+	_this->markLayoutDirty();
+
+	// The records in the journal do not apply to the restored state anymore
+	if (LayoutJournal)
+	{
+		LayoutJournal->invalidate();
+	}
+}
+
+
+//============================================================================
+void DockManagerPrivate::restoreNextSlice()
+{
+	QElapsedTimer SliceTimer;
+	SliceTimer.start();
+	while (RestoredAreaCount < PendingRestoreAreas.count())
+	{
+		const auto& PendingArea = PendingRestoreAreas[RestoredAreaCount++];
+		PrebuiltDockAreas.insert(PendingArea.second,
+			Containers[PendingArea.first]->createDockArea(AsyncRestoreModel, PendingArea.second));
+		if (SliceTimer.elapsed() >= RestoreTimeSlice)
+		{
+			break;
+		}
+	}
+
+	emit _this->restoreProgress(RestoredAreaCount, PendingRestoreAreas.count());
+	if (RestoredAreaCount < PendingRestoreAreas.count())
+	{
+		QTimer::singleShot(0, _this, [this]() {restoreNextSlice();});
+		return;
+	}
+
+	// All dock areas exist now - building the splitter trees is cheap, so
+	// the complete layout is realized and shown in one step
+	for (int i = 0; i < AsyncRestoreModel.containerCount(); ++i)
+	{
+		restoreContainer(i, AsyncRestoreModel, PrebuiltDockAreas);
+	}
+
+	qApp->removeEventFilter(RestoreInputBlocker);
+	delete RestoreInputBlocker;
+	RestoreInputBlocker = nullptr;
+	finishRestoreState(AsyncRestoreModel.containerCount());
+	AsyncRestoreModel.clear();
+	PendingRestoreAreas.clear();
+	PrebuiltDockAreas.clear();
 }
 
 
@@ -419,12 +656,30 @@ CDockManager::CDockManager(QWidget *parent) :
 	d->DockAreaOverlay = new CDockOverlay(this, CDockOverlay::ModeDockAreaOverlay);
 	d->ContainerOverlay = new CDockOverlay(this, CDockOverlay::ModeContainerOverlay);
 	d->Containers.append(this);
+	d->trackLayoutChanges(this);
+	connect(this, &CDockManager::dockAreaCreated, this, [this](CDockAreaWidget* DockArea)
+		{
+			connect(DockArea, &CDockAreaWidget::currentChanged, this, &CDockManager::markLayoutDirty);
+			connect(DockArea->titleBar()->tabBar(), &CDockAreaTabBar::tabMoved,
+				this, &CDockManager::markLayoutDirty);
+		});
 	d->loadStylesheet();
 }
 
 //============================================================================
 CDockManager::~CDockManager()
 {
+	if (d->LayoutDirty && isAutoSaveEnabled())
+	{
+		autoSaveNow();
+	}
+
+	// Deleting the floating widgets must not create journal records
+	delete d->LayoutJournal;
+	d->LayoutJournal = nullptr;
+	delete d->Profiler;
+	d->Profiler = nullptr;
+
 	auto FloatingWidgets = d->FloatingWidgets;
 	for (auto FloatingWidget : FloatingWidgets)
 	{
@@ -446,6 +701,33 @@ void CDockManager::registerFloatingWidget(CFloatingDockContainer* FloatingWidget
 void CDockManager::removeFloatingWidget(CFloatingDockContainer* FloatingWidget)
 {
 	d->FloatingWidgets.removeAll(FloatingWidget);
+	scheduleOcclusionUpdate();
+}
+
+
+//============================================================================
+void CDockManager::scheduleOcclusionUpdate()
+{
+	if (d->OcclusionUpdatePending)
+	{
+		return;
+	}
+
+	d->OcclusionUpdatePending = true;
+	QTimer::singleShot(0, this, [this]() {d->updateOcclusion();});
+}
+
+
+//============================================================================
+void CDockManager::registerDockWidget(CDockWidget* DockWidget)
+{
+	d->DockWidgetsMap.insert(DockWidget->objectName(), DockWidget);
+	d->trackLayoutChanges(DockWidget);
+	if (d->Profiler)
+	{
+		d->Profiler->addDockWidget(DockWidget);
+	}
+	DockWidget->setDockManager(this);
 }
 
 
@@ -453,6 +735,7 @@ void CDockManager::removeFloatingWidget(CFloatingDockContainer* FloatingWidget)
 void CDockManager::registerDockContainer(CDockContainerWidget* DockContainer)
 {
 	d->Containers.append(DockContainer);
+	d->trackLayoutChanges(DockContainer);
 }
 
 
@@ -481,14 +764,14 @@ CDockOverlay* CDockManager::dockAreaOverlay() const
 
 
 //============================================================================
-const QList<CDockContainerWidget*> CDockManager::dockContainers() const
+const QList<CDockContainerWidget*>& CDockManager::dockContainers() const
 {
 	return d->Containers;
 }
 
 
 //============================================================================
-const QList<CFloatingDockContainer*> CDockManager::floatingWidgets() const
+const QList<CFloatingDockContainer*>& CDockManager::floatingWidgets() const
 {
 	return d->FloatingWidgets;
 }
@@ -502,95 +785,370 @@ unsigned int CDockManager::zOrderIndex() const
 
 
 //============================================================================
-QByteArray CDockManager::saveState(int version) const
+void DockManagerPrivate::updateOcclusion()
 {
-    QByteArray xmldata;
-    QXmlStreamWriter s(&xmldata);
-    auto ConfigFlags = CDockManager::configFlags();
-	s.setAutoFormatting(ConfigFlags.testFlag(XmlAutoFormattingEnabled));
+	OcclusionUpdatePending = false;
+	if (RestoringState)
+	{
+		return;
+	}
+
+	for (auto Container : Containers)
+	{
+		// The region that is covered by the floating containers in front of
+		// this container in global coordinates
+		QRegion CoveredRegion;
+		for (auto FloatingWidget : FloatingWidgets)
+		{
+			auto FloatingContainer = FloatingWidget->dockContainer();
+			if (FloatingContainer == Container || !FloatingWidget->isVisible()
+			 || FloatingWidget->isMinimized()
+			 || FloatingContainer->zOrderIndex() <= Container->zOrderIndex())
+			{
+				continue;
+			}
+			CoveredRegion += FloatingWidget->frameGeometry();
+		}
+
+		for (auto DockArea : Container->dockAreasView())
+		{
+			bool Occluded = false;
+			if (!CoveredRegion.isEmpty() && DockArea->isVisible())
+			{
+				QRect AreaRect(DockArea->mapToGlobal(QPoint(0, 0)), DockArea->size());
+				Occluded = (QRegion(AreaRect) - CoveredRegion).isEmpty();
+			}
+			DockArea->setOccluded(Occluded);
+		}
+	}
+}
+
+
+//============================================================================
+void DockManagerPrivate::writeState(QXmlStreamWriter& s, int Version) const
+{
+	s.setAutoFormatting(CDockManager::configFlags().testFlag(CDockManager::XmlAutoFormattingEnabled));
     s.writeStartDocument();
 		s.writeStartElement("QtAdvancedDockingSystem");
-		s.writeAttribute("Version", QString::number(version));
-		s.writeAttribute("Containers", QString::number(d->Containers.count()));
-		for (auto Container : d->Containers)
+		s.writeAttribute("Version", QString::number(Version));
+		s.writeAttribute("Containers", QString::number(Containers.count()));
+		for (auto Container : Containers)
 		{
 			Container->saveState(s);
 		}
 
 		s.writeEndElement();
     s.writeEndDocument();
+}
 
-    return ConfigFlags.testFlag(XmlCompressionEnabled)
-    	? qCompress(xmldata, 9) : xmldata;
+
+//============================================================================
+QByteArray CDockManager::saveState(int version) const
+{
+    QByteArray xmldata;
+    QXmlStreamWriter s(&xmldata);
+    d->writeState(s, version);
+    return CDockManager::configFlags().testFlag(XmlCompressionEnabled)
+    	? qCompress(xmldata, d->StateCompressionLevel) : xmldata;
 }
 
 
 //============================================================================
-bool CDockManager::restoreState(const QByteArray &state, int version)
+bool CDockManager::saveState(QIODevice* Device, int version) const
 {
-	// Prevent multiple calls as long as state is not restore. This may
-	// happen, if QApplication::processEvents() is called somewhere
-	if (d->RestoringState)
+	if (!Device || !Device->isWritable())
 	{
 		return false;
 	}
 
-	// We hide the complete dock manager here. Restoring the state means
-	// that DockWidgets are removed from the DockArea internal stack layout
-	// which in turn  means, that each time a widget is removed the stack
-	// will show and raise the next available widget which in turn
-	// triggers show events for the dock widgets. To avoid this we hide the
-	// dock manager. Because there will be no processing of application
-	// events until this function is finished, the user will not see this
-	// hiding
-	bool IsHidden = this->isHidden();
-	if (!IsHidden)
-	{
-		hide();
-	}
-	d->RestoringState = true;
-	emit restoringState();
-	bool Result = d->restoreState(state, version);
-	d->RestoringState = false;
-	emit stateRestored();
-	if (!IsHidden)
+	if (!CDockManager::configFlags().testFlag(XmlCompressionEnabled))
 	{
-		show();
+		QXmlStreamWriter s(Device);
+		d->writeState(s, version);
+		return true;
 	}
 
-	return Result;
+	CCompressedStateWriter Compressor(Device, d->StateCompressionLevel);
+	QXmlStreamWriter s(&Compressor);
+	d->writeState(s, version);
+	Compressor.close();
+	return !Compressor.hasError();
 }
 
 
 //============================================================================
-CFloatingDockContainer* CDockManager::addDockWidgetFloating(CDockWidget* Dockwidget)
+void CDockManager::setStateCompressionLevel(int Level)
 {
-	d->DockWidgetsMap.insert(Dockwidget->objectName(), Dockwidget);
-	CDockAreaWidget* OldDockArea = Dockwidget->dockAreaWidget();
-	if (OldDockArea)
-	{
-		OldDockArea->removeDockWidget(Dockwidget);
-	}
-
-	Dockwidget->setDockManager(this);
-	CFloatingDockContainer* FloatingWidget = new CFloatingDockContainer(Dockwidget);
-	FloatingWidget->resize(Dockwidget->size());
-	if (isVisible())
-	{
-		FloatingWidget->show();
-	}
-	else
-	{
-		d->UninitializedFloatingWidgets.append(FloatingWidget);
-	}
-	return FloatingWidget;
+	d->StateCompressionLevel = qBound(0, Level, 9);
 }
 
 
 //============================================================================
-void CDockManager::showEvent(QShowEvent *event)
+int CDockManager::stateCompressionLevel() const
 {
-	Super::showEvent(event);
+	return d->StateCompressionLevel;
+}
+
+
+//============================================================================
+CDockLayoutModel CDockManager::layoutModel() const
+{
+	CDockLayoutModel Model;
+	for (auto Container : d->Containers)
+	{
+		Container->saveState(Model);
+	}
+	return Model;
+}
+
+
+//============================================================================
+bool CDockManager::restoreState(const QByteArray &state, int version)
+{
+	Q_UNUSED(version);
+	// Prevent multiple calls as long as state is not restore. This may
+	// happen, if QApplication::processEvents() is called somewhere
+	if (d->RestoringState)
+	{
+		return false;
+	}
+
+	// The state is parsed only once into the layout model. If the state is
+	// invalid, nothing has been changed yet
+	CDockLayoutModel Model;
+	if (!Model.fromXml(state))
+	{
+		ADS_PRINT("restoreState: Error parsing state!!!!!!!");
+		d->emitRestoreFailed();
+		return false;
+	}
+
+	return restoreState(Model);
+}
+
+
+//============================================================================
+bool CDockManager::restoreState(QIODevice* Device, int version)
+{
+	Q_UNUSED(version);
+	if (d->RestoringState || !Device || !Device->isReadable())
+	{
+		return false;
+	}
+
+	CDockLayoutModel Model;
+	if (!Model.fromXml(Device))
+	{
+		ADS_PRINT("restoreState: Error parsing state!!!!!!!");
+		d->emitRestoreFailed();
+		return false;
+	}
+
+	return restoreState(Model);
+}
+
+
+//============================================================================
+bool CDockManager::restoreState(const CDockLayoutModel& Model)
+{
+	if (d->RestoringState)
+	{
+		return false;
+	}
+
+	if (!Model.isValid())
+	{
+		d->emitRestoreFailed();
+		return false;
+	}
+
+	d->beginRestoreState();
+    for (int i = 0; i < Model.containerCount(); ++i)
+    {
+    	d->restoreContainer(i, Model);
+    }
+	d->finishRestoreState(Model.containerCount());
+	return true;
+}
+
+
+//============================================================================
+bool CDockManager::restoreStateAsync(const QByteArray& state, int TimeSliceMs)
+{
+	if (d->RestoringState)
+	{
+		return false;
+	}
+
+	CDockLayoutModel Model;
+	if (!Model.fromXml(state) || !Model.isValid())
+	{
+		return false;
+	}
+
+	d->beginRestoreState();
+	d->RestoreInputBlocker = new CRestoreInputBlocker(this);
+	qApp->installEventFilter(d->RestoreInputBlocker);
+
+	// The dock areas are created in the containers they belong to, so we
+	// need to create the required floating widgets first
+	while (d->Containers.count() < Model.containerCount())
+	{
+		new CFloatingDockContainer(this);
+	}
+
+	d->AsyncRestoreModel = Model;
+	d->RestoreTimeSlice = TimeSliceMs;
+	d->RestoredAreaCount = 0;
+	for (int i = 0; i < Model.containerCount(); ++i)
+	{
+		for (auto AreaNode : Model.areaNodes(i))
+		{
+			d->PendingRestoreAreas.append(qMakePair(i, AreaNode));
+		}
+	}
+
+	emit restoreProgress(0, d->PendingRestoreAreas.count());
+	QTimer::singleShot(0, this, [this]() {d->restoreNextSlice();});
+	return true;
+}
+
+
+//============================================================================
+CFloatingDockContainer* CDockManager::addDockWidgetFloating(CDockWidget* Dockwidget)
+{
+	if (d->RestoringState)
+	{
+		ADS_PRINT("CDockManager::addDockWidgetFloating: ignored while restoring state");
+		return nullptr;
+	}
+
+	registerDockWidget(Dockwidget);
+	CDockAreaWidget* OldDockArea = Dockwidget->dockAreaWidget();
+	if (OldDockArea)
+	{
+		OldDockArea->removeDockWidget(Dockwidget);
+	}
+
+	CFloatingDockContainer* FloatingWidget = new CFloatingDockContainer(Dockwidget);
+	FloatingWidget->resize(Dockwidget->size());
+	showFloatingWidget(FloatingWidget);
+	return FloatingWidget;
+}
+
+
+//============================================================================
+static DockWidgetArea dockWidgetAreaFromVariant(const QVariant& Value)
+{
+	if (Value.type() == QVariant::String)
+	{
+		static const QHash<QString, DockWidgetArea> AreaNames =
+		{
+			{"left", LeftDockWidgetArea},
+			{"right", RightDockWidgetArea},
+			{"top", TopDockWidgetArea},
+			{"bottom", BottomDockWidgetArea},
+			{"center", CenterDockWidgetArea}
+		};
+		return AreaNames.value(Value.toString().toLower(), CenterDockWidgetArea);
+	}
+
+	bool Ok;
+	int Area = Value.toInt(&Ok);
+	return Ok ? static_cast<DockWidgetArea>(Area) : CenterDockWidgetArea;
+}
+
+
+//============================================================================
+QList<CDockWidget*> CDockManager::addDockWidgets(const QVariantList& Layout)
+{
+	QList<CDockWidget*> Result;
+	if (d->RestoringState)
+	{
+		ADS_PRINT("CDockManager::addDockWidgets: ignored while restoring state");
+		return Result;
+	}
+
+	Result.reserve(Layout.count());
+	bool UpdatesEnabled = updatesEnabled();
+	setUpdatesEnabled(false);
+	for (const auto& Entry : Layout)
+	{
+		const auto Spec = Entry.toMap();
+		const auto Title = Spec.value("title").toString();
+		if (Title.isEmpty())
+		{
+			ADS_PRINT("CDockManager::addDockWidgets: entry without title skipped");
+			continue;
+		}
+
+		auto Widget = qvariant_cast<QWidget*>(Spec.value("widget"));
+		if (!Widget)
+		{
+			ADS_PRINT("CDockManager::addDockWidgets: entry without content widget skipped");
+			continue;
+		}
+
+		auto DockWidget = new CDockWidget(Title);
+		const auto Name = Spec.value("name").toString();
+		if (!Name.isEmpty())
+		{
+			DockWidget->setObjectName(Name);
+		}
+
+		DockWidget->setWidget(Widget);
+
+		if (Spec.contains("features"))
+		{
+			DockWidget->setFeatures(CDockWidget::DockWidgetFeatures(Spec.value("features").toInt()));
+		}
+
+		if (Spec.contains("icon"))
+		{
+			DockWidget->setIcon(qvariant_cast<QIcon>(Spec.value("icon")));
+		}
+
+		if (Spec.value("floating").toBool())
+		{
+			addDockWidgetFloating(DockWidget);
+		}
+		else
+		{
+			auto Target = findDockWidget(Spec.value("target").toString());
+			addDockWidget(dockWidgetAreaFromVariant(Spec.value("area")), DockWidget,
+				Target ? Target->dockAreaWidget() : nullptr);
+		}
+
+		if (Spec.value("closed").toBool())
+		{
+			DockWidget->toggleView(false);
+		}
+		Result.append(DockWidget);
+	}
+
+	setUpdatesEnabled(UpdatesEnabled);
+	return Result;
+}
+
+
+//============================================================================
+void CDockManager::showFloatingWidget(CFloatingDockContainer* FloatingWidget)
+{
+	if (isVisible())
+	{
+		FloatingWidget->show();
+	}
+	else
+	{
+		d->UninitializedFloatingWidgets.append(FloatingWidget);
+	}
+}
+
+
+//============================================================================
+void CDockManager::showEvent(QShowEvent *event)
+{
+	Super::showEvent(event);
 	if (d->UninitializedFloatingWidgets.empty())
 	{
 		return;
@@ -604,11 +1162,50 @@ void CDockManager::showEvent(QShowEvent *event)
 }
 
 
+//============================================================================
+void CDockManager::moveEvent(QMoveEvent *event)
+{
+	Super::moveEvent(event);
+	scheduleOcclusionUpdate();
+}
+
+
+//============================================================================
+void CDockManager::resizeEvent(QResizeEvent *event)
+{
+	Super::resizeEvent(event);
+	scheduleOcclusionUpdate();
+}
+
+
+//============================================================================
+bool CDockManager::event(QEvent *e)
+{
+	switch (e->type())
+	{
+	case QEvent::StyleChange:
+	case QEvent::ApplicationPaletteChange:
+		iconProvider().clearIconCache();
+		break;
+
+	default:
+		break;
+	}
+	return Super::event(e);
+}
+
+
 //============================================================================
 CDockAreaWidget* CDockManager::addDockWidget(DockWidgetArea area,
 	CDockWidget* Dockwidget, CDockAreaWidget* DockAreaWidget)
 {
-	d->DockWidgetsMap.insert(Dockwidget->objectName(), Dockwidget);
+	if (d->RestoringState)
+	{
+		ADS_PRINT("CDockManager::addDockWidget: ignored while restoring state");
+		return nullptr;
+	}
+
+	registerDockWidget(Dockwidget);
 	return CDockContainerWidget::addDockWidget(area, Dockwidget, DockAreaWidget);
 }
 
@@ -622,7 +1219,7 @@ CDockAreaWidget* CDockManager::addDockWidgetTab(DockWidgetArea area,
 	{
 		return addDockWidget(ads::CenterDockWidgetArea, Dockwidget, AreaWidget);
 	}
-	else if (!openedDockAreas().isEmpty())
+	else if (!openedDockAreasView().isEmpty())
 	{
 		return addDockWidget(area, Dockwidget, openedDockAreas().last());
 	}
@@ -650,14 +1247,33 @@ CDockWidget* CDockManager::findDockWidget(const QString& ObjectName) const
 //============================================================================
 void CDockManager::removeDockWidget(CDockWidget* Dockwidget)
 {
+	// Removing the dock widget now would modify the layout that is restored
+	if (d->RestoringState)
+	{
+		if (!d->DeferredRemovals.contains(Dockwidget))
+		{
+			d->DeferredRemovals.append(Dockwidget);
+		}
+		return;
+	}
+
+	CLayoutJournalScope JournalScope(this);
+	if (JournalScope.isActive())
+	{
+		JournalScope.record(CDockLayoutJournal::DockWidgetRemoved, {Dockwidget->objectName()});
+	}
 	emit dockWidgetAboutToBeRemoved(Dockwidget);
 	d->DockWidgetsMap.remove(Dockwidget->objectName());
+	if (d->Profiler)
+	{
+		d->Profiler->removeDockWidget(Dockwidget);
+	}
 	CDockContainerWidget::removeDockWidget(Dockwidget);
 	emit dockWidgetRemoved(Dockwidget);
 }
 
 //============================================================================
-QMap<QString, CDockWidget*> CDockManager::dockWidgetsMap() const
+const QMap<QString, CDockWidget*>& CDockManager::dockWidgetsMap() const
 {
 	return d->DockWidgetsMap;
 }
@@ -815,6 +1431,110 @@ int CDockManager::startDragDistance()
 }
 
 
+//===========================================================================
+void CDockManager::enableAutoSave(const QString& FilePath, int DelayMs)
+{
+	d->AutoSaveDevice = nullptr;
+	d->AutoSaveFilePath = FilePath;
+	d->setupAutoSaveTimer(DelayMs);
+}
+
+
+//===========================================================================
+void CDockManager::enableAutoSave(QIODevice* Device, int DelayMs)
+{
+	d->AutoSaveFilePath.clear();
+	d->AutoSaveDevice = Device;
+	d->setupAutoSaveTimer(DelayMs);
+}
+
+
+//===========================================================================
+void CDockManager::disableAutoSave()
+{
+	if (d->AutoSaveTimer)
+	{
+		d->AutoSaveTimer->stop();
+	}
+	d->AutoSaveFilePath.clear();
+	d->AutoSaveDevice = nullptr;
+	d->AutoSaveHash.clear();
+}
+
+
+//===========================================================================
+bool CDockManager::isAutoSaveEnabled() const
+{
+	return !d->AutoSaveFilePath.isEmpty() || d->AutoSaveDevice;
+}
+
+
+//===========================================================================
+bool CDockManager::isLayoutDirty() const
+{
+	return d->LayoutDirty;
+}
+
+
+//===========================================================================
+void CDockManager::markLayoutDirty()
+{
+	// Restoring the state triggers a lot of layout changes - we mark the
+	// layout dirty only once when the restore is finished
+	if (d->RestoringState)
+	{
+		return;
+	}
+
+	d->LayoutDirty = true;
+	if (d->AutoSaveTimer && isAutoSaveEnabled())
+	{
+		d->AutoSaveTimer->start();
+	}
+}
+
+
+//===========================================================================
+bool CDockManager::autoSaveNow()
+{
+	if (d->AutoSaveTimer)
+	{
+		d->AutoSaveTimer->stop();
+	}
+
+	if (!isAutoSaveEnabled())
+	{
+		return false;
+	}
+
+	if (!d->LayoutDirty)
+	{
+		return true;
+	}
+
+	// Many layout changes, like a splitter dragged back and forth, do not
+	// change the serialized state. We only write, if the content changed
+	auto State = saveState();
+	auto Hash = QCryptographicHash::hash(State, QCryptographicHash::Md5);
+	d->LayoutDirty = false;
+	if (Hash == d->AutoSaveHash)
+	{
+		return true;
+	}
+
+	if (!d->writeAutoSaveState(State))
+	{
+		ADS_PRINT("CDockManager::autoSaveNow: Error writing state");
+		d->LayoutDirty = true;
+		return false;
+	}
+
+	d->AutoSaveHash = Hash;
+	emit stateAutoSaved();
+	return true;
+}
+
+
 //===========================================================================
 CDockManager::ConfigFlags CDockManager::configFlags()
 {
@@ -844,6 +1564,101 @@ CIconProvider& CDockManager::iconProvider()
 }
 
 
+//===========================================================================
+void CDockManager::setDragPreviewScaleFactor(qreal Factor)
+{
+	StaticDragPreviewScaleFactor = qBound(0.05, Factor, 1.0);
+}
+
+
+//===========================================================================
+qreal CDockManager::dragPreviewScaleFactor()
+{
+	return StaticDragPreviewScaleFactor;
+}
+
+
+//===========================================================================
+QString CDockManager::defaultStyleSheet()
+{
+	// Initialized once and thread safe - all managers share the string data
+	static const QString StyleSheet = []()
+	{
+#ifdef Q_OS_LINUX
+		QFile StyleSheetFile(":ads/stylesheets/default_linux.css");
+#else
+		QFile StyleSheetFile(":ads/stylesheets/default.css");
+#endif
+		StyleSheetFile.open(QIODevice::ReadOnly);
+		return QString::fromUtf8(StyleSheetFile.readAll());
+	}();
+	return StyleSheet;
+}
+
+
+//===========================================================================
+void CDockManager::installApplicationStyleSheet()
+{
+	if (StaticApplicationStyleSheetInstalled)
+	{
+		return;
+	}
+
+	StaticApplicationStyleSheetInstalled = true;
+	qApp->setStyleSheet(qApp->styleSheet() + QLatin1Char('\n') + defaultStyleSheet());
+}
+
+
+//===========================================================================
+bool CDockManager::isApplicationStyleSheetInstalled()
+{
+	return StaticApplicationStyleSheetInstalled;
+}
+
+
+//===========================================================================
+void CDockManager::setLayoutJournalEnabled(bool Enabled)
+{
+	if (Enabled && !d->LayoutJournal)
+	{
+		d->LayoutJournal = new CDockLayoutJournal(this);
+	}
+	else if (!Enabled && d->LayoutJournal)
+	{
+		delete d->LayoutJournal;
+		d->LayoutJournal = nullptr;
+	}
+}
+
+
+//===========================================================================
+CDockLayoutJournal* CDockManager::layoutJournal() const
+{
+	return d->LayoutJournal;
+}
+
+
+//===========================================================================
+void CDockManager::setProfilingEnabled(bool Enabled)
+{
+	if (Enabled && !d->Profiler)
+	{
+		d->Profiler = new CDockWidgetProfiler(this);
+	}
+	else if (!Enabled && d->Profiler)
+	{
+		delete d->Profiler;
+		d->Profiler = nullptr;
+	}
+}
+
+
+//===========================================================================
+CDockWidgetProfiler* CDockManager::profiler() const
+{
+	return d->Profiler;
+}
+
 } // namespace ads
 
 //---------------------------------------------------------------------------
@@ -41,10 +41,12 @@
 #include <qobjectdefs.h>
 #include <qstring.h>
 #include <qstringlist.h>
+#include <qvariant.h>
 #include <QtGui/qicon.h>
 
 class QSettings;
 class QMenu;
+class QIODevice;
 
 namespace ads
 {
@@ -55,10 +57,15 @@ class CDockContainerWidget;
 class DockContainerWidgetPrivate;
 class CDockOverlay;
 class CDockAreaTabBar;
+class CDockLayoutModel;
 class CDockWidgetTab;
 struct DockWidgetTabPrivate;
 struct DockAreaWidgetPrivate;
 class CIconProvider;
+class CDockLayoutJournal;
+struct DockLayoutJournalPrivate;
+class CDockWidgetProfiler;
+class CDockLayoutBuilder;
 
 /**
  * The central dock manager that maintains the complete docking system.
@@ -88,8 +95,16 @@ private:
 	friend struct DockWidgetTabPrivate;
 	friend class CFloatingOverlay;
 	friend struct FloatingOverlayPrivate;
+	friend struct DockLayoutJournalPrivate;
+	friend class CDockLayoutBuilder;
 
 protected:
+	/**
+	 * Registers the given dock widget in the map of dock widgets without
+	 * adding it to a dock area
+	 */
+	void registerDockWidget(CDockWidget* DockWidget);
+
 	/**
 	 * Registers the given floating widget in the internal list of
 	 * floating widgets
@@ -113,6 +128,14 @@ protected:
 	 */
 	void removeDockContainer(CDockContainerWidget* DockContainer);
 
+	/**
+	 * Schedules the update of the occluded flag of all dock areas.
+	 * Called if the geometry, the visibility or the z order of a floating
+	 * container changed. All calls until control returns to the event loop
+	 * are coalesced into a single update.
+	 */
+	void scheduleOcclusionUpdate();
+
 	/**
 	 * Overlay for containers
 	 */
@@ -123,11 +146,35 @@ protected:
 	 */
 	CDockOverlay* dockAreaOverlay() const;
 
+	/**
+	 * Shows the given new floating widget or defers showing it until the
+	 * dock manager becomes visible
+	 */
+	void showFloatingWidget(CFloatingDockContainer* FloatingWidget);
+
 	/**
 	 * Show the floating widgets that has been created floating
 	 */
 	virtual void showEvent(QShowEvent *event) override;
 
+	/**
+	 * Updates the occluded state of the dock areas if the dock manager
+	 * has been moved
+	 */
+	virtual void moveEvent(QMoveEvent *event) override;
+
+	/**
+	 * Updates the occluded state of the dock areas if the dock manager
+	 * has been resized
+	 */
+	virtual void resizeEvent(QResizeEvent *event) override;
+
+	/**
+	 * Clears the cached standard icons of the icon provider if the style
+	 * or the application palette changed
+	 */
+	virtual bool event(QEvent *e) override;
+
 public:
 	using Super = CDockContainerWidget;
 
@@ -156,6 +203,8 @@ public:
 		DragPreviewIsDynamic = 0x0400,///< If opaque undocking is disabled, this flag defines the behavior of the drag preview window, if this flag is enabled, the preview will be adjusted dynamically to the drop area
 		DragPreviewShowsContentPixmap = 0x0800,///< If opaque undocking is disabled, the created drag preview window shows a copy of the content of the dock widget / dock are that is dragged
 		DragPreviewHasWindowFrame = 0x1000,///< If opaque undocking is disabled, then this flag configures if the drag preview is frameless or looks like a real window
+		ThrottledSplitterResize = 0x2000,///< If opaque splitter resizing is enabled, this flag limits the rate of the live resize updates to about one per frame - see CDockSplitter::setResizeThrottleInterval()
+		FloatingContainerReleasesNativeWindow = 0x4000,///< If enabled, hidden floating containers release their native window and backing store. The window is recreated if the floating container is shown again
 		DefaultConfig = ActiveTabHasCloseButton
 		              | DockAreaHasCloseButton
 		              | OpaqueSplitterResize
@@ -210,6 +259,40 @@ public:
 	 */
 	static CIconProvider& iconProvider();
 
+	/**
+	 * Sets the factor that is used to scale down the content pixmap of the
+	 * drag preview if the DragPreviewShowsContentPixmap flag is set.
+	 * A factor of 1.0 renders the preview in full resolution. The default
+	 * factor is 0.5.
+	 */
+	static void setDragPreviewScaleFactor(qreal Factor);
+
+	/**
+	 * Returns the scale factor of the drag preview content pixmap
+	 */
+	static qreal dragPreviewScaleFactor();
+
+	/**
+	 * Returns the default stylesheet of the docking system.
+	 * The stylesheet is read from the resources only once per process and
+	 * all dock managers share the same string data.
+	 */
+	static QString defaultStyleSheet();
+
+	/**
+	 * Appends the default stylesheet once to the application stylesheet.
+	 * Dock managers that are created afterwards do not set their own
+	 * stylesheet. So Qt parses the style data only once for all managers
+	 * instead of once per manager. Call this function before you create your
+	 * first dock manager - managers that already exist keep their own copy.
+	 */
+	static void installApplicationStyleSheet();
+
+	/**
+	 * Returns true, if installApplicationStyleSheet() has been called
+	 */
+	static bool isApplicationStyleSheetInstalled();
+
 	/**
 	 * Adds dockwidget into the given area.
 	 * If DockAreaWidget is not null, then the area parameter indicates the area
@@ -222,6 +305,7 @@ public:
 	 * 	   ExisitingDockArea);
 	 * \endcode
 	 * \return Returns the dock area widget that contains the new DockWidget
+	 * or nullptr, if the dock manager is restoring a state
 	 */
 	CDockAreaWidget* addDockWidget(DockWidgetArea area, CDockWidget* Dockwidget,
 		CDockAreaWidget* DockAreaWidget = nullptr);
@@ -248,6 +332,32 @@ public:
 	 */
 	CFloatingDockContainer* addDockWidgetFloating(CDockWidget* Dockwidget);
 
+	/**
+	 * Creates and adds multiple dock widgets in a single call.
+	 * This is much faster for language bindings than creating and adding
+	 * each dock widget with individual calls.
+	 * Each entry of the Layout list is a QVariantMap that describes one dock
+	 * widget. The entries are processed in order with the following keys:
+	 * - "title" - the window title of the new dock widget (required)
+	 * - "name" - the object name, the title is used if the name is missing
+	 * - "widget" - the content widget (QWidget*) (required)
+	 * - "area" - the DockWidgetArea as integer or as one of the strings
+	 *   "left", "right", "top", "bottom" or "center" - default is "center"
+	 * - "target" - the name of a dock widget of a previous entry or an
+	 *   already registered dock widget. The new dock widget is added into
+	 *   "area" of the dock area of this widget. If there is no target, the
+	 *   dock widget is added into "area" of the dock manager container
+	 * - "features" - the dock widget features as integer
+	 * - "icon" - the icon of the dock widget (QIcon)
+	 * - "floating" - if true, the dock widget is added floating
+	 * - "closed" - if true, the dock widget is closed after it has been added
+	 *
+	 * Entries without title or without a valid content widget are skipped.
+	 * The function returns the created
+	 * dock widgets in the order of the Layout list.
+	 */
+	QList<CDockWidget*> addDockWidgets(const QVariantList& Layout);
+
 	/**
 	 * Searches for a registered doc widget with the given ObjectName
 	 * \return Return the found dock widget or nullptr if a dock widget with the
@@ -256,7 +366,9 @@ public:
 	CDockWidget* findDockWidget(const QString& ObjectName) const;
 
 	/**
-	 * Remove the given Dock from the dock manager
+	 * Remove the given Dock from the dock manager.
+	 * If a state is being restored, the dock widget is removed when the
+	 * restore has finished.
 	 */
 	void removeDockWidget(CDockWidget* Dockwidget);
 
@@ -264,18 +376,18 @@ public:
 	 * This function returns a readable reference to the internal dock
 	 * widgets map so that it is possible to iterate over all dock widgets
 	 */
-	QMap<QString, CDockWidget*> dockWidgetsMap() const;
+	const QMap<QString, CDockWidget*>& dockWidgetsMap() const;
 
 	/**
 	 * Returns the list of all active and visible dock containers
 	 * Dock containers are the main dock manager and all floating widgets
 	 */
-	const QList<CDockContainerWidget*> dockContainers() const;
+	const QList<CDockContainerWidget*>& dockContainers() const;
 
 	/**
 	 * Returns the list of all floating widgets
 	 */
-	const QList<CFloatingDockContainer*> floatingWidgets() const;
+	const QList<CFloatingDockContainer*>& floatingWidgets() const;
 
 	/**
 	 * This function always return 0 because the main window is always behind
@@ -293,6 +405,39 @@ public:
 	 */
 	QByteArray saveState(int version = Version1) const;
 
+	/**
+	 * Writes the current state into the given device that needs to be open
+	 * for writing.
+	 * If XmlCompressionEnabled is set, the XML data is compressed in chunks
+	 * via CCompressedStateWriter while it is written. So the complete
+	 * state is never kept in memory. Returns false, if writing to the device
+	 * failed.
+	 */
+	bool saveState(QIODevice* Device, int version = Version1) const;
+
+	/**
+	 * Predefined zlib compression levels for setStateCompressionLevel()
+	 */
+	enum eStateCompressionLevel
+	{
+		FastestStateCompression = 1,
+		BestStateCompression = 9
+	};
+
+	/**
+	 * Sets the zlib compression level from 0 to 9 that is used by
+	 * saveState() if XmlCompressionEnabled is set. The default level
+	 * BestStateCompression creates the smallest states but is several times
+	 * slower than FastestStateCompression. All levels are read by
+	 * restoreState() without any further configuration.
+	 */
+	void setStateCompressionLevel(int Level);
+
+	/**
+	 * Returns the compression level set via setStateCompressionLevel()
+	 */
+	int stateCompressionLevel() const;
+
 	/**
 	 * Restores the state of this dockmanagers dockwidgets.
 	 * The version number is compared with that stored in state. If they do
@@ -302,6 +447,52 @@ public:
 	 */
 	bool restoreState(const QByteArray &state, int version = Version1);
 
+	/**
+	 * Restores the state from the given device that needs to be open for
+	 * reading. Uncompressed states and states written with compression by
+	 * saveState(QIODevice*) are read incrementally.
+	 */
+	bool restoreState(QIODevice* Device, int version = Version1);
+
+	/**
+	 * Restores the layout described by the given layout model.
+	 * Returns false and leaves the current layout unchanged, if the
+	 * model is not valid.
+	 */
+	bool restoreState(const CDockLayoutModel& Model);
+
+	/**
+	 * Returns the widget free layout model of the current layout.
+	 * The model is built directly from the containers, splitters and dock
+	 * areas without serializing the state.
+	 */
+	CDockLayoutModel layoutModel() const;
+
+	/**
+	 * Default time slice for restoreStateAsync() in milliseconds
+	 */
+	static const int DefaultRestoreTimeSlice = 10;
+
+	/**
+	 * Restores the given state without blocking the event loop for the
+	 * complete restore.
+	 * The state is parsed immediately and the dock areas are created from
+	 * the event loop in slices of at most TimeSliceMs milliseconds. After
+	 * each slice, restoreProgress() is emitted. While the restore is running,
+	 * the dock manager and all floating widgets are hidden and do not accept
+	 * user input. Calls that would change the layout while the restore is
+	 * running are not applied: the addDockWidget functions return nullptr,
+	 * CDockWidget::toggleView() and CDockWidget::setFloating() are ignored
+	 * and removeDockWidget() and CDockWidget::deleteDockWidget() are
+	 * deferred until the restore has finished. The restored layout is shown
+	 * in one step and stateRestored() is emitted when the restore has
+	 * finished.
+	 * Returns false and leaves the current layout unchanged, if the state is
+	 * invalid or if a restore is already running.
+	 */
+	bool restoreStateAsync(const QByteArray& state,
+		int TimeSliceMs = DefaultRestoreTimeSlice);
+
 	/**
 	 * Saves the current perspective to the internal list of perspectives.
 	 * A perspective is the current state of the dock manager assigned
@@ -387,12 +578,88 @@ public:
 	 */
 	static int startDragDistance();
 
+	/**
+	 * Enables automatic saving of the dock manager state into the file with
+	 * the given FilePath.
+	 * Every layout change marks the state dirty and restarts a debounce timer.
+	 * The state is serialized if no further change happens within DelayMs
+	 * milliseconds. The file is written atomically via QSaveFile and only if
+	 * the serialized state differs from the last written one.
+	 */
+	void enableAutoSave(const QString& FilePath, int DelayMs = 1000);
+
+	/**
+	 * Enables automatic saving of the dock manager state into the given
+	 * device. The device needs to be open for writing and is not owned by
+	 * the dock manager. Random access devices are rewritten from the start
+	 * on each save.
+	 */
+	void enableAutoSave(QIODevice* Device, int DelayMs = 1000);
+
+	/**
+	 * Disables the automatic saving of the dock manager state
+	 */
+	void disableAutoSave();
+
+	/**
+	 * Returns true, if auto save is enabled
+	 */
+	bool isAutoSaveEnabled() const;
+
+	/**
+	 * Returns true, if the layout changed since the last automatic save
+	 */
+	bool isLayoutDirty() const;
+
+	/**
+	 * Immediately writes a pending dirty state to the auto save target
+	 * without waiting for the debounce timer.
+	 * Returns false, if auto save is disabled or if writing failed.
+	 */
+	bool autoSaveNow();
+
+	/**
+	 * Enables or disables the recording of layout operations into the
+	 * layout journal. Disabling the journal deletes all records.
+	 * \see CDockLayoutJournal
+	 */
+	void setLayoutJournalEnabled(bool Enabled);
+
+	/**
+	 * Returns the layout journal or a nullptr, if the journal is not enabled
+	 */
+	CDockLayoutJournal* layoutJournal() const;
+
+	/**
+	 * Enables or disables the measurement of the paint, resize, layout
+	 * request and show event times of all registered dock widgets.
+	 * Disabling the profiler deletes all measured times. The times are
+	 * measured by CDockWidgetProfiler::notify() that the application needs
+	 * to call from its QApplication::notify() reimplementation.
+	 * \see CDockWidgetProfiler
+	 */
+	void setProfilingEnabled(bool Enabled);
+
+	/**
+	 * Returns the dock widget profiler or a nullptr, if profiling is not
+	 * enabled
+	 */
+	CDockWidgetProfiler* profiler() const;
+
 public slots:
 	/**
 	 * Opens the perspective with the given name.
 	 */
 	void openPerspective(const QString& PerspectiveName);
 
+	/**
+	 * Marks the layout as changed and restarts the auto save debounce timer.
+	 * The dock manager calls this function for all layout changes it knows
+	 * of. Call it, if your application changes the layout in a way the dock
+	 * manager does not track.
+	 */
+	void markLayoutDirty();
+
 signals:
 	/**
 	 * This signal is emitted if the list of perspectives changed
@@ -418,6 +685,13 @@ signals:
      */
     void stateRestored();
 
+    /**
+     * This signal is emitted after each slice of restoreStateAsync().
+     * Done is the number of dock areas created so far and Total the
+     * number of all dock areas of the restored state.
+     */
+    void restoreProgress(int Done, int Total);
+
     /**
      * This signal is emitted, if the dock manager starts opening a
      * perspective.
@@ -454,6 +728,12 @@ signals:
      * docking system but it is not deleted yet.
      */
     void dockWidgetRemoved(CDockWidget* DockWidget);
+
+    /**
+     * This signal is emitted if the auto save function has written a changed
+     * state to the auto save file or device
+     */
+    void stateAutoSaved();
 }; // class DockManager
 } // namespace ads
 //-----------------------------------------------------------------------------
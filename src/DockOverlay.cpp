@@ -160,19 +160,17 @@ struct DockOverlayCrossPrivate
 		l->setPixmap(createHighDpiDropIndicatorPixmap(size, DockWidgetArea, Mode));
 		l->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint);
 		l->setAttribute(Qt::WA_TranslucentBackground);
-		l->setProperty("dockWidgetArea", DockWidgetArea);
 		return l;
 	}
 
 	//============================================================================
-	void updateDropIndicatorIcon(QWidget* DropIndicatorWidget)
+	void updateDropIndicatorIcon(DockWidgetArea Area, QWidget* DropIndicatorWidget)
 	{
 		QLabel* l = qobject_cast<QLabel*>(DropIndicatorWidget);
         const qreal metric = dropIndicatiorWidth(l);
 		const QSizeF size(metric, metric);
 
-		int Area = l->property("dockWidgetArea").toInt();
-		l->setPixmap(createHighDpiDropIndicatorPixmap(size, (DockWidgetArea)Area, Mode));
+		l->setPixmap(createHighDpiDropIndicatorPixmap(size, Area, Mode));
 	}
 
 	//============================================================================
@@ -627,9 +625,9 @@ void CDockOverlayCross::updateOverlayIcons()
 		return;
 	}
 
-	for (auto Widget : d->DropIndicatorWidgets)
+	for (auto it = d->DropIndicatorWidgets.cbegin(); it != d->DropIndicatorWidgets.cend(); ++it)
 	{
-		d->updateDropIndicatorIcon(Widget);
+		d->updateDropIndicatorIcon(it.key(), it.value());
 	}
 #if QT_VESION >= 0x050600
 	d->LastDevicePixelRatio = devicePixelRatioF();
@@ -31,8 +31,13 @@
 
 #include <QDebug>
 #include <QChildEvent>
+#include <QMouseEvent>
+#include <QTimer>
+#include <QSet>
 
 #include "DockAreaWidget.h"
+#include "DockWidget.h"
+#include "DockContainerWidget.h"
 
 namespace ads
 {
@@ -42,11 +47,188 @@ namespace ads
 struct DockSplitterPrivate
 {
 	CDockSplitter* _this;
-	int VisibleContentCount = 0;
+	QSet<QObject*> VisibleWidgets;
+	int ResizeThrottleInterval = 0;
+	CDockContainerWidget* DockContainer = nullptr;
 
 	DockSplitterPrivate(CDockSplitter* _public) : _this(_public) {}
+
+	/**
+	 * Updates the visibility of the given child in the set of visible
+	 * children
+	 */
+	void updateVisibleWidget(QWidget* Widget, bool Visible)
+	{
+		if (Visible)
+		{
+			VisibleWidgets.insert(Widget);
+		}
+		else
+		{
+			VisibleWidgets.remove(Widget);
+		}
+	}
+
+	/**
+	 * Notifies the dock widgets on both sides of the given handle about the
+	 * start or the end of a resize operation
+	 */
+	void notifyResize(QSplitterHandle* Handle, bool InProgress);
+
+	/**
+	 * Sets the dock container of this splitter and of all dock areas and
+	 * splitters in its subtree
+	 */
+	void setDockContainer(CDockContainerWidget* Container);
 };
 
+
+/**
+ * Splitter handle that coalesces the mouse moves of an opaque resize and
+ * applies the last position with the throttle interval of the splitter
+ */
+class CDockSplitterHandle : public QSplitterHandle
+{
+private:
+	QTimer* ThrottleTimer = nullptr;
+	int MouseOffset = 0;
+	int PendingPos = -1;
+	bool Pressed = false;
+
+	CDockSplitter* dockSplitter() const
+	{
+		return static_cast<CDockSplitter*>(splitter());
+	}
+
+	int pick(const QPoint& Pos) const
+	{
+		return (orientation() == Qt::Horizontal) ? Pos.x() : Pos.y();
+	}
+
+	void applyPendingPos()
+	{
+		if (PendingPos < 0)
+		{
+			return;
+		}
+
+		int Pos = PendingPos;
+		PendingPos = -1;
+		moveSplitter(Pos);
+	}
+
+protected:
+	virtual void mousePressEvent(QMouseEvent* e) override
+	{
+		QSplitterHandle::mousePressEvent(e);
+		if (e->button() == Qt::LeftButton)
+		{
+			MouseOffset = pick(e->pos());
+			Pressed = true;
+			dockSplitter()->d->notifyResize(this, true);
+		}
+	}
+
+	virtual void mouseMoveEvent(QMouseEvent* e) override
+	{
+		int Interval = dockSplitter()->resizeThrottleInterval();
+		if (!Pressed || !opaqueResize() || Interval <= 0
+		 || !(e->buttons() & Qt::LeftButton))
+		{
+			QSplitterHandle::mouseMoveEvent(e);
+			return;
+		}
+
+		PendingPos = pick(parentWidget()->mapFromGlobal(e->globalPos())) - MouseOffset;
+		if (!ThrottleTimer)
+		{
+			ThrottleTimer = new QTimer(this);
+			ThrottleTimer->setSingleShot(true);
+			QObject::connect(ThrottleTimer, &QTimer::timeout, this, [this]() {applyPendingPos();});
+		}
+
+		if (!ThrottleTimer->isActive())
+		{
+			ThrottleTimer->start(Interval);
+		}
+	}
+
+	virtual void mouseReleaseEvent(QMouseEvent* e) override
+	{
+		if (ThrottleTimer)
+		{
+			ThrottleTimer->stop();
+		}
+		applyPendingPos();
+		QSplitterHandle::mouseReleaseEvent(e);
+		if (Pressed && e->button() == Qt::LeftButton)
+		{
+			Pressed = false;
+			dockSplitter()->d->notifyResize(this, false);
+		}
+	}
+
+public:
+	CDockSplitterHandle(Qt::Orientation Orientation, CDockSplitter* Parent)
+		: QSplitterHandle(Orientation, Parent)
+	{
+
+	}
+};
+
+
+//============================================================================
+void DockSplitterPrivate::setDockContainer(CDockContainerWidget* Container)
+{
+	DockContainer = Container;
+	for (int i = 0; i < _this->count(); ++i)
+	{
+		auto Widget = _this->widget(i);
+		auto Splitter = qobject_cast<CDockSplitter*>(Widget);
+		if (Splitter)
+		{
+			Splitter->d->setDockContainer(Container);
+			continue;
+		}
+
+		auto DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+		if (DockArea)
+		{
+			DockArea->setDockContainer(Container);
+		}
+	}
+}
+
+
+//============================================================================
+void DockSplitterPrivate::notifyResize(QSplitterHandle* Handle, bool InProgress)
+{
+	// The handle with index i is placed in front of the widget with index i
+	int Index = _this->indexOf(Handle);
+	for (int i = Index - 1; i <= Index; ++i)
+	{
+		auto Widget = _this->widget(i);
+		if (!Widget)
+		{
+			continue;
+		}
+
+		for (auto DockWidget : Widget->findChildren<CDockWidget*>())
+		{
+			DockWidget->setSplitterResizeInProgress(InProgress);
+		}
+	}
+
+	if (InProgress)
+	{
+		emit _this->splitterResizeStarted();
+	}
+	else
+	{
+		emit _this->splitterResizeFinished();
+	}
+}
+
 //============================================================================
 CDockSplitter::CDockSplitter(QWidget *parent)
 	: QSplitter(parent),
@@ -76,16 +258,82 @@ CDockSplitter::~CDockSplitter()
 //============================================================================
 bool CDockSplitter::hasVisibleContent() const
 {
-	// TODO Cache or precalculate this to speed up
-	for (int i = 0; i < count(); ++i)
+	return !d->VisibleWidgets.isEmpty();
+}
+
+
+//============================================================================
+void CDockSplitter::childEvent(QChildEvent* event)
+{
+	QSplitter::childEvent(event);
+
+	// A deleted child may already be destroyed down to its QObject part
+	// here - so we must not cast it
+	if (event->removed())
 	{
-		if (!widget(i)->isHidden())
-		{
-			return true;
-		}
+		d->VisibleWidgets.remove(event->child());
 	}
+}
+
+
+//============================================================================
+void CDockSplitter::updateChildVisibility(QWidget* Child)
+{
+	d->updateVisibleWidget(Child, Child->parentWidget() == this
+		&& !Child->isHidden());
+}
+
 
-	return false;
+//============================================================================
+void CDockSplitter::setVisible(bool Visible)
+{
+	QSplitter::setVisible(Visible);
+	auto ParentSplitter = qobject_cast<CDockSplitter*>(parentWidget());
+	if (ParentSplitter)
+	{
+		ParentSplitter->updateChildVisibility(this);
+	}
+}
+
+
+//============================================================================
+bool CDockSplitter::event(QEvent* e)
+{
+	// If a splitter is temporarily unparented, it keeps its dock container
+	if (e->type() == QEvent::ParentChange && parentWidget())
+	{
+		d->setDockContainer(internal::parentDockContainer(parentWidget()));
+	}
+
+	return QSplitter::event(e);
+}
+
+
+//============================================================================
+CDockContainerWidget* CDockSplitter::dockContainer() const
+{
+	return d->DockContainer;
+}
+
+
+//============================================================================
+QSplitterHandle* CDockSplitter::createHandle()
+{
+	return new CDockSplitterHandle(orientation(), this);
+}
+
+
+//============================================================================
+void CDockSplitter::setResizeThrottleInterval(int Milliseconds)
+{
+	d->ResizeThrottleInterval = qMax(0, Milliseconds);
+}
+
+
+//============================================================================
+int CDockSplitter::resizeThrottleInterval() const
+{
+	return d->ResizeThrottleInterval;
 }
 
 } // namespace ads
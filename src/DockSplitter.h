@@ -36,6 +36,9 @@
 namespace ads
 {
 struct DockSplitterPrivate;
+class CDockSplitterHandle;
+class CDockContainerWidget;
+class CDockAreaWidget;
 
 /**
  * Splitter used internally instead of QSplitter with some additional
@@ -47,8 +50,40 @@ class ADS_EXPORT CDockSplitter : public QSplitter
 private:
 	DockSplitterPrivate* d;
 	friend struct DockSplitterPrivate;
+	friend class CDockSplitterHandle;
+	friend class CDockAreaWidget;
+
+	/**
+	 * Updates the set of visible content widgets. The dock areas and dock
+	 * splitters call this function from their setVisible() function if
+	 * they are children of this splitter.
+	 */
+	void updateChildVisibility(QWidget* Child);
+
+protected:
+	/**
+	 * Creates a splitter handle that supports rate limited opaque resizing
+	 */
+	virtual QSplitterHandle* createHandle() override;
+
+	/**
+	 * Removes content widgets that are removed from this splitter from the
+	 * set of visible content widgets
+	 */
+	virtual void childEvent(QChildEvent* event) override;
+
+	/**
+	 * Updates the cached dock container if the splitter is reparented
+	 */
+	virtual bool event(QEvent* e) override;
 
 public:
+	/**
+	 * Default interval for throttled opaque resizing - about one update
+	 * per frame
+	 */
+	static const int DefaultResizeThrottleInterval = 16;
+
 	CDockSplitter(QWidget *parent = Q_NULLPTR);
 	CDockSplitter(Qt::Orientation orientation, QWidget *parent = Q_NULLPTR);
 
@@ -58,9 +93,47 @@ public:
 	virtual ~CDockSplitter();
 
 	/**
-	 * Returns true, if any of the internal widgets is visible
+	 * Returns true, if any of the internal widgets is visible.
+	 * The splitter keeps track of its visible children, so this function
+	 * does not need to check all children.
 	 */
 	bool hasVisibleContent() const;
+
+	/**
+	 * Updates the visible content of the parent splitter
+	 */
+	virtual void setVisible(bool Visible) override;
+
+	/**
+	 * Returns the dock container that contains this splitter.
+	 * The container is cached and updated if this splitter or one of its
+	 * parent splitters is reparented.
+	 */
+	CDockContainerWidget* dockContainer() const;
+
+	/**
+	 * If opaque resizing is enabled, the handle movements are coalesced and
+	 * the splitter applies the last position at most once per given
+	 * interval in milliseconds. A value of 0 disables the throttling and
+	 * each mouse move resizes the widgets immediately.
+	 */
+	void setResizeThrottleInterval(int Milliseconds);
+
+	/**
+	 * Returns the resize throttle interval
+	 */
+	int resizeThrottleInterval() const;
+
+signals:
+	/**
+	 * This signal is emitted if the user starts dragging a splitter handle
+	 */
+	void splitterResizeStarted();
+
+	/**
+	 * This signal is emitted if the user releases a splitter handle
+	 */
+	void splitterResizeFinished();
 }; // class CDockSplitter
 
 } // namespace ads
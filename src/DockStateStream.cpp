@@ -0,0 +1,350 @@
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockStateStream.cpp
+/// \date   19.10.2026
+/// \brief  Implementation of CCompressedStateWriter and CCompressedStateReader
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockStateStream.h"
+
+#include <QtEndian>
+
+namespace ads
+{
+static const QByteArray StreamMagic("ADSC");
+static const int HeaderSize = 4;
+/// Limits the memory that is allocated for a chunk of a corrupt stream
+static const quint32 MaxChunkSize = 16 * 1024 * 1024;
+
+
+/**
+ * Private data class of CCompressedStateWriter class (pimpl)
+ */
+struct CompressedStateWriterPrivate
+{
+	CCompressedStateWriter* _this;
+	QIODevice* Device;
+	QByteArray Buffer;
+	int ChunkSize;
+	int CompressionLevel;
+	bool Failed = false;
+
+	/**
+	 * Private data constructor
+	 */
+	CompressedStateWriterPrivate(CCompressedStateWriter* _public,
+		QIODevice* Device, int CompressionLevel, int ChunkSize);
+
+	/**
+	 * Compresses the buffered data and writes it as one chunk to the
+	 * target device
+	 */
+	bool writeChunk();
+};
+// struct CompressedStateWriterPrivate
+
+
+//============================================================================
+CompressedStateWriterPrivate::CompressedStateWriterPrivate(
+	CCompressedStateWriter* _public, QIODevice* Device, int CompressionLevel,
+	int ChunkSize) :
+	_this(_public),
+	Device(Device),
+	ChunkSize(qBound(1, ChunkSize, int(MaxChunkSize) / 2)),
+	CompressionLevel(CompressionLevel)
+{
+
+}
+
+
+//============================================================================
+bool CompressedStateWriterPrivate::writeChunk()
+{
+	if (Buffer.isEmpty())
+	{
+		return true;
+	}
+
+	QByteArray Chunk = qCompress(Buffer, CompressionLevel);
+	// resize() keeps the reserved capacity for the next chunk
+	Buffer.resize(0);
+	uchar Header[HeaderSize];
+	qToBigEndian<quint32>(Chunk.size(), Header);
+	if (Device->write(reinterpret_cast<const char*>(Header), HeaderSize) != HeaderSize
+	 || Device->write(Chunk) != Chunk.size())
+	{
+		Failed = true;
+	}
+	return !Failed;
+}
+
+
+//============================================================================
+CCompressedStateWriter::CCompressedStateWriter(QIODevice* Device,
+	int CompressionLevel, int ChunkSize) :
+	d(new CompressedStateWriterPrivate(this, Device, CompressionLevel, ChunkSize))
+{
+	d->Buffer.reserve(d->ChunkSize);
+	QIODevice::open(QIODevice::WriteOnly);
+	d->Failed = (d->Device->write(StreamMagic) != StreamMagic.size());
+}
+
+
+//============================================================================
+CCompressedStateWriter::~CCompressedStateWriter()
+{
+	if (isOpen())
+	{
+		close();
+	}
+	delete d;
+}
+
+
+//============================================================================
+qint64 CCompressedStateWriter::readData(char* data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+	return -1;
+}
+
+
+//============================================================================
+qint64 CCompressedStateWriter::writeData(const char* data, qint64 maxSize)
+{
+	if (d->Failed)
+	{
+		return -1;
+	}
+
+	qint64 Remaining = maxSize;
+	while (Remaining > 0)
+	{
+		int Count = int(qMin<qint64>(Remaining, d->ChunkSize - d->Buffer.size()));
+		d->Buffer.append(data, Count);
+		data += Count;
+		Remaining -= Count;
+		if (d->Buffer.size() >= d->ChunkSize && !d->writeChunk())
+		{
+			return -1;
+		}
+	}
+	return maxSize;
+}
+
+
+//============================================================================
+void CCompressedStateWriter::close()
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+	if (d->writeChunk())
+	{
+		uchar EndMarker[HeaderSize];
+		qToBigEndian<quint32>(0, EndMarker);
+		d->Failed = d->Device->write(reinterpret_cast<const char*>(EndMarker), HeaderSize) != HeaderSize;
+	}
+	QIODevice::close();
+}
+
+
+//============================================================================
+bool CCompressedStateWriter::hasError() const
+{
+	return d->Failed;
+}
+
+
+/**
+ * Private data class of CCompressedStateReader class (pimpl)
+ */
+struct CompressedStateReaderPrivate
+{
+	CCompressedStateReader* _this;
+	QIODevice* Device;
+	QByteArray Buffer;
+	int Pos = 0;
+	bool Finished = false;
+	bool Failed = false;
+
+	/**
+	 * Private data constructor
+	 */
+	CompressedStateReaderPrivate(CCompressedStateReader* _public, QIODevice* Device);
+
+	/**
+	 * Reads the next chunk from the source device and uncompresses it
+	 * into the buffer
+	 */
+	bool readChunk();
+};
+// struct CompressedStateReaderPrivate
+
+
+//============================================================================
+CompressedStateReaderPrivate::CompressedStateReaderPrivate(
+	CCompressedStateReader* _public, QIODevice* Device) :
+	_this(_public),
+	Device(Device)
+{
+
+}
+
+
+//============================================================================
+bool CompressedStateReaderPrivate::readChunk()
+{
+	Buffer.clear();
+	Pos = 0;
+	QByteArray Header = Device->read(HeaderSize);
+	if (Header.size() != HeaderSize)
+	{
+		Failed = true;
+		return false;
+	}
+
+	quint32 Count = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(Header.constData()));
+	if (!Count)
+	{
+		Finished = true;
+		return false;
+	}
+
+	if (Count > MaxChunkSize)
+	{
+		Failed = true;
+		return false;
+	}
+
+	QByteArray Chunk = Device->read(Count);
+	if (Chunk.size() != int(Count))
+	{
+		Failed = true;
+		return false;
+	}
+
+	Buffer = qUncompress(Chunk);
+	Failed = Buffer.isEmpty();
+	return !Failed;
+}
+
+
+//============================================================================
+CCompressedStateReader::CCompressedStateReader(QIODevice* Device) :
+	d(new CompressedStateReaderPrivate(this, Device))
+{
+	QIODevice::open(QIODevice::ReadOnly);
+	d->Failed = (d->Device->read(StreamMagic.size()) != StreamMagic);
+	d->Finished = d->Failed;
+}
+
+
+//============================================================================
+CCompressedStateReader::~CCompressedStateReader()
+{
+	delete d;
+}
+
+
+//============================================================================
+qint64 CCompressedStateReader::readData(char* data, qint64 maxSize)
+{
+	qint64 Count = 0;
+	while (Count < maxSize)
+	{
+		if (d->Pos >= d->Buffer.size())
+		{
+			if (d->Finished || d->Failed || !d->readChunk())
+			{
+				break;
+			}
+		}
+
+		int n = int(qMin<qint64>(maxSize - Count, d->Buffer.size() - d->Pos));
+		memcpy(data + Count, d->Buffer.constData() + d->Pos, n);
+		d->Pos += n;
+		Count += n;
+	}
+
+	if (d->Failed)
+	{
+		return -1;
+	}
+
+	return (Count || !d->Finished) ? Count : -1;
+}
+
+
+//============================================================================
+qint64 CCompressedStateReader::writeData(const char* data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+	return -1;
+}
+
+
+//============================================================================
+bool CCompressedStateReader::atEnd() const
+{
+	return (d->Finished || d->Failed) && d->Pos >= d->Buffer.size()
+		&& QIODevice::bytesAvailable() == 0;
+}
+
+
+//============================================================================
+qint64 CCompressedStateReader::bytesAvailable() const
+{
+	return (d->Buffer.size() - d->Pos) + QIODevice::bytesAvailable();
+}
+
+
+//============================================================================
+bool CCompressedStateReader::hasError() const
+{
+	return d->Failed;
+}
+
+
+//============================================================================
+bool CCompressedStateReader::isCompressedState(QIODevice* Device)
+{
+	return Device->peek(StreamMagic.size()) == StreamMagic;
+}
+
+
+//============================================================================
+bool CCompressedStateReader::isCompressedState(const QByteArray& State)
+{
+	return State.startsWith(StreamMagic);
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockStateStream.cpp
@@ -0,0 +1,148 @@
+#ifndef DockStateStreamH
+#define DockStateStreamH
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockStateStream.h
+/// \date   19.10.2026
+/// \brief  Declaration of CCompressedStateWriter and CCompressedStateReader
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QByteArray>
+#include <QIODevice>
+
+#include "ads_globals.h"
+
+namespace ads
+{
+struct CompressedStateWriterPrivate;
+struct CompressedStateReaderPrivate;
+
+/**
+ * Write only device that compresses the data written to it in chunks and
+ * writes the compressed chunks to the target device. This allows writing
+ * a compressed state without keeping the complete uncompressed and
+ * compressed state in memory.
+ * The stream starts with the magic bytes "ADSC" followed by the chunks.
+ * Each chunk is stored as 32 bit big endian byte count followed by the
+ * qCompress() data of the chunk. A zero byte count marks the end of the
+ * stream. The end marker is written by close().
+ */
+class ADS_EXPORT CCompressedStateWriter : public QIODevice
+{
+private:
+	CompressedStateWriterPrivate* d; ///< private data (pimpl)
+	friend struct CompressedStateWriterPrivate;
+
+protected:
+	virtual qint64 readData(char* data, qint64 maxSize) override;
+	virtual qint64 writeData(const char* data, qint64 maxSize) override;
+
+public:
+	/**
+	 * Default number of uncompressed bytes per chunk
+	 */
+	static const int DefaultChunkSize = 64 * 1024;
+
+	/**
+	 * Creates an opened writer for the given target device. The target
+	 * device needs to be opened for writing.
+	 */
+	CCompressedStateWriter(QIODevice* Device, int CompressionLevel = 9,
+		int ChunkSize = DefaultChunkSize);
+
+	/**
+	 * Closes the writer if it is still open
+	 */
+	virtual ~CCompressedStateWriter();
+
+	/**
+	 * Writes the remaining buffered data and the end marker
+	 */
+	virtual void close() override;
+
+	virtual bool isSequential() const override {return true;}
+
+	/**
+	 * Returns true, if writing to the target device failed
+	 */
+	bool hasError() const;
+}; // class CCompressedStateWriter
+
+
+/**
+ * Read only device that reads the chunks of a stream written by
+ * CCompressedStateWriter from the source device and uncompresses one chunk
+ * at a time.
+ * The source device needs to provide the complete stream - i.e. a file or
+ * a buffer.
+ */
+class ADS_EXPORT CCompressedStateReader : public QIODevice
+{
+private:
+	CompressedStateReaderPrivate* d; ///< private data (pimpl)
+	friend struct CompressedStateReaderPrivate;
+
+protected:
+	virtual qint64 readData(char* data, qint64 maxSize) override;
+	virtual qint64 writeData(const char* data, qint64 maxSize) override;
+
+public:
+	/**
+	 * Creates an opened reader for the given source device. The magic bytes
+	 * are consumed from the source device.
+	 */
+	CCompressedStateReader(QIODevice* Device);
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CCompressedStateReader();
+
+	virtual bool isSequential() const override {return true;}
+	virtual bool atEnd() const override;
+	virtual qint64 bytesAvailable() const override;
+
+	/**
+	 * Returns true, if the source device does not contain a valid
+	 * compressed stream
+	 */
+	bool hasError() const;
+
+	/**
+	 * Returns true, if the next bytes of the given device are the magic
+	 * bytes of a compressed stream. No data is consumed from the device.
+	 */
+	static bool isCompressedState(QIODevice* Device);
+
+	/**
+	 * Returns true, if the given state starts with the magic bytes of a
+	 * compressed stream
+	 */
+	static bool isCompressedState(const QByteArray& State);
+}; // class CCompressedStateReader
+} // namespace ads
+
+//-----------------------------------------------------------------------------
+#endif // DockStateStreamH
@@ -42,12 +42,15 @@
 #include <QDebug>
 #include <QToolBar>
 #include <QXmlStreamWriter>
+#include <QPainter>
+#include <QTimer>
 
 #include "DockContainerWidget.h"
 #include "DockAreaWidget.h"
 #include "DockManager.h"
 #include "FloatingDockContainer.h"
 #include "DockSplitter.h"
+#include "DockLayoutJournal.h"
 #include "ads_globals.h"
 
 
@@ -74,12 +77,28 @@ struct DockWidgetPrivate
 	QSize ToolBarIconSizeDocked = QSize(16, 16);
 	QSize ToolBarIconSizeFloating = QSize(24, 24);
 	bool IsFloatingTopLevel = false;
+	QPixmap PreviewPixmap;
+	bool PreviewPixmapDirty = false;
+	bool RenderingPreviewPixmap = false;
+	QTimer* PreviewPixmapTimer = nullptr;
+	bool SplitterResizeInProgress = false;
+	bool RestoreDirty = false;
+	bool RestoredClosed = false;
+	CDockWidget::eVisibilityState VisibilityState = CDockWidget::ContentHidden;
+	bool VisibilityUpdatePending = false;
 
 	/**
 	 * Private data constructor
 	 */
 	DockWidgetPrivate(CDockWidget* _public);
 
+	/**
+	 * Renders the preview pixmap when the content widget did not change for
+	 * PreviewPixmapRenderDelay milliseconds, so that the first drag of the
+	 * dock widget does not need to render the content
+	 */
+	void schedulePreviewPixmapRender();
+
 	/**
 	 * Show dock widget
 	 */
@@ -117,6 +136,33 @@ DockWidgetPrivate::DockWidgetPrivate(CDockWidget* _public) :
 }
 
 
+//============================================================================
+void DockWidgetPrivate::schedulePreviewPixmapRender()
+{
+	if (!CDockManager::configFlags().testFlag(CDockManager::DragPreviewShowsContentPixmap))
+	{
+		return;
+	}
+
+	if (!PreviewPixmapTimer)
+	{
+		PreviewPixmapTimer = new QTimer(_this);
+		PreviewPixmapTimer->setSingleShot(true);
+		PreviewPixmapTimer->setInterval(CDockWidget::PreviewPixmapRenderDelay);
+		QObject::connect(PreviewPixmapTimer, &QTimer::timeout, _this, [this]()
+			{
+				if (PreviewPixmap.isNull() && _this->isVisible())
+				{
+					_this->renderPreviewPixmap();
+				}
+			});
+	}
+
+	// Restarting the timer defers the rendering until a resize is finished
+	PreviewPixmapTimer->start();
+}
+
+
 //============================================================================
 void DockWidgetPrivate::showDockWidget()
 {
@@ -131,19 +177,19 @@ void DockWidgetPrivate::showDockWidget()
 		DockArea->toggleView(true);
 		DockArea->setCurrentDockWidget(_this);
 		TabWidget->show();
-		QSplitter* Splitter = internal::findParent<QSplitter*>(DockArea);
-		while (Splitter && !Splitter->isVisible())
+		// A splitter that is not hidden is visible content of its parent
+		// splitter - so all splitters above it are already shown
+		QSplitter* Splitter = qobject_cast<QSplitter*>(DockArea->parentWidget());
+		while (Splitter && Splitter->isHidden())
 		{
 			Splitter->show();
-			Splitter = internal::findParent<QSplitter*>(Splitter);
+			Splitter = qobject_cast<QSplitter*>(Splitter->parentWidget());
 		}
 
 		CDockContainerWidget* Container = DockArea->dockContainer();
 		if (Container->isFloating())
 		{
-			CFloatingDockContainer* FloatingWidget = internal::findParent<
-					CFloatingDockContainer*>(Container);
-			FloatingWidget->show();
+			Container->floatingWidget()->show();
 		}
 	}
 }
@@ -259,6 +305,9 @@ void CDockWidget::setWidget(QWidget* widget, eInsertMode InsertMode)
 
 	d->Widget = widget;
 	d->Widget->setProperty("dockWidgetContent", true);
+	d->Widget->installEventFilter(this);
+	d->PreviewPixmap = QPixmap();
+	d->schedulePreviewPixmapRender();
 }
 
 
@@ -267,6 +316,8 @@ QWidget* CDockWidget::takeWidget()
 {
 	d->ScrollArea->takeWidget();
 	d->Layout->removeWidget(d->Widget);
+	d->Widget->removeEventFilter(this);
+	d->PreviewPixmap = QPixmap();
 	d->Widget->setParent(nullptr);
     return d->Widget;
 }
@@ -294,6 +345,7 @@ void CDockWidget::setFeatures(DockWidgetFeatures features)
 		return;
 	}
 	d->Features = features;
+	emit featuresChanged(d->Features);
 	d->TabWidget->onDockWidgetFeaturesChanged();
 }
 
@@ -386,6 +438,60 @@ bool CDockWidget::isClosed() const
 }
 
 
+//============================================================================
+CDockWidget::eVisibilityState CDockWidget::visibilityState() const
+{
+	if (d->Closed)
+	{
+		return ContentClosed;
+	}
+
+	if (!d->DockArea)
+	{
+		return ContentHidden;
+	}
+
+	if (d->DockArea->currentDockWidget() != this)
+	{
+		return ContentInactiveTab;
+	}
+
+	if (window()->isMinimized())
+	{
+		return isInFloatingContainer() ? ContentFloatingMinimized : ContentHidden;
+	}
+
+	if (!isVisible())
+	{
+		return ContentHidden;
+	}
+
+	return d->DockArea->isOccluded() ? ContentOccluded : ContentVisible;
+}
+
+
+//============================================================================
+void CDockWidget::updateVisibilityState()
+{
+	if (d->VisibilityUpdatePending)
+	{
+		return;
+	}
+
+	d->VisibilityUpdatePending = true;
+	QTimer::singleShot(0, this, [this]()
+	{
+		d->VisibilityUpdatePending = false;
+		auto State = visibilityState();
+		if (State != d->VisibilityState)
+		{
+			d->VisibilityState = State;
+			emit visibilityStateChanged(State);
+		}
+	});
+}
+
+
 //============================================================================
 QAction* CDockWidget::toggleViewAction() const
 {
@@ -412,6 +518,17 @@ void CDockWidget::setToggleViewActionMode(eToggleViewActionMode Mode)
 //============================================================================
 void CDockWidget::toggleView(bool Open)
 {
+	// The layout must not change while the dock manager restores a state.
+	// The toggle view action may have changed its checked state already,
+	// so we reset it to the current state
+	if (d->DockManager && d->DockManager->isRestoringState())
+	{
+		d->ToggleViewAction->blockSignals(true);
+		d->ToggleViewAction->setChecked(!d->Closed);
+		d->ToggleViewAction->blockSignals(false);
+		return;
+	}
+
 	// If the toggle view action mode is ActionModeShow, then Open is always
 	// true if the sender is the toggle view action
 	QAction* Sender = qobject_cast<QAction*>(sender());
@@ -436,6 +553,13 @@ void CDockWidget::toggleView(bool Open)
 //============================================================================
 void CDockWidget::toggleViewInternal(bool Open)
 {
+	CLayoutJournalScope JournalScope(d->DockManager);
+	if (JournalScope.isActive())
+	{
+		JournalScope.record(Open ? CDockLayoutJournal::DockWidgetOpened
+			: CDockLayoutJournal::DockWidgetClosed, {objectName()});
+	}
+
 	CDockContainerWidget* DockContainer = dockContainer();
 	CDockWidget* TopLevelDockWidgetBefore = DockContainer
 		? DockContainer->topLevelDockWidget() : nullptr;
@@ -475,6 +599,9 @@ void CDockWidget::toggleViewInternal(bool Open)
 		FloatingContainer->updateWindowTitle();
 	}
 
+	// Closing or opening a widget that is not the current tab does not
+	// show or hide anything
+	updateVisibilityState();
 	if (!Open)
 	{
 		emit closed();
@@ -532,10 +659,123 @@ bool CDockWidget::event(QEvent *e)
 		}
 		emit titleChanged(title);
 	}
+	// Covers tab switches and closing as well as minimizing and restoring
+	// of the window because Qt sends spontaneous show and hide events then
+	else if (e->type() == QEvent::Show || e->type() == QEvent::Hide)
+	{
+		updateVisibilityState();
+	}
 	return Super::event(e);
 }
 
 
+//============================================================================
+bool CDockWidget::eventFilter(QObject* watched, QEvent* e)
+{
+	// The rendering of the preview pixmap paints the content widget, so we
+	// ignore the events that are caused by the rendering
+	if (watched != d->Widget || d->RenderingPreviewPixmap)
+	{
+		return Super::eventFilter(watched, e);
+	}
+
+	switch (e->type())
+	{
+	case QEvent::Resize:
+		// A pixmap with the old size is useless for the preview
+		d->PreviewPixmap = QPixmap();
+		d->schedulePreviewPixmapRender();
+		break;
+
+	case QEvent::Show:
+		if (d->PreviewPixmap.isNull())
+		{
+			d->schedulePreviewPixmapRender();
+		}
+		break;
+
+	case QEvent::Paint:
+	case QEvent::UpdateRequest:
+		// The content changed - the cached pixmap is still good enough to
+		// start a drag, but it is rendered again, when a drag starts
+		d->PreviewPixmapDirty = true;
+		break;
+
+	default:
+		break;
+	}
+
+	return Super::eventFilter(watched, e);
+}
+
+
+//============================================================================
+void CDockWidget::setSplitterResizeInProgress(bool InProgress)
+{
+	if (d->SplitterResizeInProgress == InProgress)
+	{
+		return;
+	}
+
+	d->SplitterResizeInProgress = InProgress;
+	if (InProgress)
+	{
+		emit splitterResizeStarted();
+	}
+	else
+	{
+		emit splitterResizeFinished();
+	}
+}
+
+
+//============================================================================
+bool CDockWidget::isSplitterResizeInProgress() const
+{
+	return d->SplitterResizeInProgress;
+}
+
+
+//============================================================================
+QPixmap CDockWidget::previewPixmap() const
+{
+	return d->PreviewPixmap;
+}
+
+
+//============================================================================
+void CDockWidget::invalidatePreviewPixmap()
+{
+	d->PreviewPixmapDirty = true;
+}
+
+
+//============================================================================
+QPixmap CDockWidget::renderPreviewPixmap()
+{
+	if (!d->PreviewPixmap.isNull() && !d->PreviewPixmapDirty)
+	{
+		return d->PreviewPixmap;
+	}
+
+	// Rendering into a downscaled pixmap is much cheaper for big content
+	// widgets and the preview is shown semi transparent anyway
+	qreal ScaleFactor = CDockManager::dragPreviewScaleFactor();
+	QSize Size = (QSizeF(size()) * ScaleFactor).toSize().expandedTo(QSize(1, 1));
+	QPixmap Pixmap(Size);
+	d->RenderingPreviewPixmap = true;
+	QPainter Painter(&Pixmap);
+	Painter.setRenderHint(QPainter::SmoothPixmapTransform);
+	Painter.scale(ScaleFactor, ScaleFactor);
+	render(&Painter);
+	Painter.end();
+	d->RenderingPreviewPixmap = false;
+	d->PreviewPixmap = Pixmap;
+	d->PreviewPixmapDirty = false;
+	return Pixmap;
+}
+
+
 #ifndef QT_NO_TOOLTIP
 //============================================================================
 void CDockWidget::setTabToolTip(const QString &text)
@@ -719,6 +959,28 @@ void CDockWidget::setClosedState(bool Closed)
 }
 
 
+//============================================================================
+void CDockWidget::setRestoreState(bool Dirty, bool Closed)
+{
+	d->RestoreDirty = Dirty;
+	d->RestoredClosed = Closed;
+}
+
+
+//============================================================================
+bool CDockWidget::isRestoreDirty() const
+{
+	return d->RestoreDirty;
+}
+
+
+//============================================================================
+bool CDockWidget::restoredClosedState() const
+{
+	return d->RestoredClosed;
+}
+
+
 //============================================================================
 QSize CDockWidget::minimumSizeHint() const
 {
@@ -729,7 +991,7 @@ QSize CDockWidget::minimumSizeHint() const
 //============================================================================
 void CDockWidget::setFloating()
 {
-	if (isClosed())
+	if (isClosed() || (d->DockManager && d->DockManager->isRestoringState()))
 	{
 		return;
 	}
@@ -740,6 +1002,15 @@ void CDockWidget::setFloating()
 //============================================================================
 void CDockWidget::deleteDockWidget()
 {
+	// The restored layout may still reference this dock widget, so it is
+	// deleted when the restore has finished
+	if (d->DockManager && d->DockManager->isRestoringState())
+	{
+		connect(d->DockManager, &CDockManager::stateRestored, this,
+			&CDockWidget::deleteDockWidget, Qt::UniqueConnection);
+		return;
+	}
+
 	dockManager()->removeDockWidget(this);
 	deleteLater();
 }
@@ -74,6 +74,7 @@ protected:
 	friend class CDockAreaTabBar;
 	friend class CDockWidgetTab;
 	friend struct DockWidgetTabPrivate;
+	friend struct DockSplitterPrivate;
 
 	/**
 	 * Assigns the dock manager that manages this dock widget
@@ -129,12 +130,45 @@ protected:
 	 */
 	void setClosedState(bool Closed);
 
+	/**
+	 * Internal function for the dock manager to keep track of the dock
+	 * widgets that are processed when restoring a saved docking state.
+	 * The dock manager marks all dock widgets as dirty before it restores
+	 * the state. If a dock widget is found in the saved state, it is marked
+	 * as not dirty and Closed is the closed state read from the saved state.
+	 */
+	void setRestoreState(bool Dirty, bool Closed);
+
+	/**
+	 * Returns true, if the dock widget has not been found in the saved
+	 * state during the last restore
+	 */
+	bool isRestoreDirty() const;
+
+	/**
+	 * Returns the closed state that has been read from the saved state
+	 */
+	bool restoredClosedState() const;
+
 	/**
 	 * Internal toggle view function that does not check if the widget
 	 * already is in the given state
 	 */
 	void toggleViewInternal(bool Open);
 
+	/**
+	 * Schedules the emission of visibilityStateChanged() if the visibility
+	 * state changed. All changes up to the next event loop iteration are
+	 * coalesced into a single notification.
+	 */
+	void updateVisibilityState();
+
+	/**
+	 * Called by the dock splitter if the user starts or finishes dragging
+	 * a splitter handle that resizes this dock widget
+	 */
+	void setSplitterResizeInProgress(bool InProgress);
+
 public:
 	using Super = QFrame;
 
@@ -156,6 +190,21 @@ public:
 		StateFloating
 	};
 
+	/**
+	 * Describes why the content of a dock widget is visible or not
+	 * visible on screen.
+	 * \see visibilityState()
+	 */
+	enum eVisibilityState
+	{
+		ContentVisible,          ///< the content is visible on screen
+		ContentInactiveTab,      ///< another tab of the dock area is the current tab
+		ContentClosed,           ///< the dock widget is closed
+		ContentFloatingMinimized,///< the floating container of the dock widget is minimized
+		ContentHidden,           ///< the window is minimized or hidden or the dock widget is not docked
+		ContentOccluded          ///< the dock area is completely covered by floating containers
+	};
+
 	/**
 	 * Sets the widget for the dock widget to widget.
 	 * The InsertMode defines how the widget is inserted into the dock widget.
@@ -194,6 +243,12 @@ public:
 		ActionModeShow   //!< ActionModeShow
 	};
 
+	/**
+	 * Time in milliseconds the content widget needs to be unchanged in size
+	 * before the preview pixmap is rendered in advance
+	 */
+	static const int PreviewPixmapRenderDelay = 500;
+
 
 	/**
 	 * This constructor creates a dock widget with the given title.
@@ -313,6 +368,13 @@ public:
 	 */
 	bool isClosed() const;
 
+	/**
+	 * Returns the current visibility state of the content of this dock
+	 * widget. Use this function and the visibilityStateChanged() signal to
+	 * pause updates of content that is not on screen.
+	 */
+	eVisibilityState visibilityState() const;
+
 	/**
 	 * Returns a checkable action that can be used to show or close this dock widget.
 	 * The action's text is set to the dock widget's window title.
@@ -402,31 +464,78 @@ public:
 	void setTabToolTip(const QString &text);
 #endif
 
+	/**
+	 * Returns the cached preview pixmap that is shown by the drag preview
+	 * if the DragPreviewShowsContentPixmap flag is set.
+	 * The pixmap is rendered with CDockManager::dragPreviewScaleFactor()
+	 * when the content widget is shown or resized and did not change its
+	 * size for PreviewPixmapRenderDelay milliseconds. The pixmap may show
+	 * outdated content if the content widget has been repainted since
+	 * then. Returns a null pixmap, if no pixmap has been rendered for the
+	 * current size of the content widget.
+	 */
+	QPixmap previewPixmap() const;
+
+	/**
+	 * Marks the cached preview pixmap as outdated, so that the next
+	 * renderPreviewPixmap() call renders it again. Repaints of the content
+	 * widget mark the pixmap as outdated automatically. Call this function
+	 * if only child widgets of the content widget changed.
+	 */
+	void invalidatePreviewPixmap();
+
+	/**
+	 * Renders the preview pixmap, if there is no cached pixmap or if the
+	 * cached pixmap is outdated, and returns it
+	 */
+	QPixmap renderPreviewPixmap();
+
+	/**
+	 * Returns true, while the user drags a splitter handle that resizes
+	 * this dock widget.
+	 * Content widgets with expensive painting can use this to paint a
+	 * cheaper representation during the resize.
+	 */
+	bool isSplitterResizeInProgress() const;
+
 public: // reimplements QFrame -----------------------------------------------
 	/**
 	 * Emits titleChanged signal if title change event occurs
 	 */
 	virtual bool event(QEvent *e) override;
 
+	/**
+	 * Invalidates the cached preview pixmap if the content widget changes
+	 */
+	virtual bool eventFilter(QObject* watched, QEvent* e) override;
+
 public slots:
 	/**
 	 * This property controls whether the dock widget is open or closed.
-	 * The toogleViewAction triggers this slot
+	 * The toogleViewAction triggers this slot.
+	 * The call is ignored while the dock manager restores a state.
 	 */
 	void toggleView(bool Open = true);
 
 	/**
-	 * This function will make a docked widget floating
+	 * This function will make a docked widget floating.
+	 * The call is ignored while the dock manager restores a state.
 	 */
 	void setFloating();
 
 	/**
 	 * This function will delete the dock widget and its content from the
-	 * docking system
+	 * docking system. If the dock manager restores a state, the dock widget
+	 * is deleted when the restore has finished.
 	 */
 	void deleteDockWidget();
 
 signals:
+	/**
+	 * This signal is emitted if the features of this dock widget changed
+	 */
+	void featuresChanged(ads::CDockWidget::DockWidgetFeatures features);
+
 	/**
 	 * This signal is emitted if the dock widget is opened or closed
 	 */
@@ -437,6 +546,18 @@ signals:
 	 */
 	void closed();
 
+	/**
+	 * This signal is emitted if the visibility state of the content
+	 * changed.
+	 * Opening, closing and docking dock widgets, switching tabs and restoring
+	 * a state shows and hides widgets several times. So the signal is not
+	 * emitted immediately but from the event loop after the change has been
+	 * completed. It is emitted only once per event loop iteration and only
+	 * if the new state differs from the state of the last emission. The
+	 * initial state is ContentHidden.
+	 */
+	void visibilityStateChanged(ads::CDockWidget::eVisibilityState State);
+
 	/**
 	 * This signal is emitted if the window title of this dock widget
 	 * changed
@@ -449,6 +570,19 @@ signals:
 	 * otherwise it is false.
 	 */
 	void topLevelChanged(bool topLevel);
+
+	/**
+	 * This signal is emitted if the user starts dragging a splitter handle
+	 * that resizes this dock widget
+	 */
+	void splitterResizeStarted();
+
+	/**
+	 * This signal is emitted if the user releases the splitter handle.
+	 * Content widgets that paint a cheap representation during the resize
+	 * should repaint their full content now.
+	 */
+	void splitterResizeFinished();
 }; // class DockWidget
 }
  // namespace ads
@@ -0,0 +1,362 @@
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockWidgetProfiler.cpp
+/// \date   19.10.2026
+/// \brief  Implementation of CDockWidgetProfiler class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockWidgetProfiler.h"
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QHash>
+#include <QTextStream>
+#include <QWidget>
+
+#include "DockManager.h"
+#include "DockWidget.h"
+
+
+namespace ads
+{
+static const char* const CategoryNames[CDockWidgetProfiler::EventCategoryCount] =
+{
+	"paint",
+	"resize",
+	"layout",
+	"show"
+};
+
+static QList<CDockWidgetProfiler*> StaticProfilers;
+static int StaticDispatchDepth = 0;
+
+
+/**
+ * Private data class of CDockWidgetProfiler class (pimpl)
+ */
+struct DockWidgetProfilerPrivate
+{
+	CDockWidgetProfiler* _this;
+	CDockManager* DockManager;
+	QHash<QObject*, CDockWidget*> WatchedObjects;
+	QHash<CDockWidget*, CDockWidgetProfiler::Entry> Entries;
+	int EventBudget = 0;
+
+	/**
+	 * Private data constructor
+	 */
+	DockWidgetProfilerPrivate(CDockWidgetProfiler* _public);
+
+	/**
+	 * Installs the event filter on the given widget and all its child
+	 * widgets and attributes their events to DockWidget
+	 */
+	void watch(QWidget* Widget, CDockWidget* DockWidget);
+
+	/**
+	 * Returns the measured category of the given event type or -1 if the
+	 * event is not measured
+	 */
+	static int eventCategory(QEvent::Type Type);
+
+	/**
+	 * Adds the time of a single event to the entry of the given dock widget
+	 */
+	void addEventTime(CDockWidget* DockWidget, int Category, qint64 Elapsed);
+};
+// struct DockWidgetProfilerPrivate
+
+
+//============================================================================
+DockWidgetProfilerPrivate::DockWidgetProfilerPrivate(CDockWidgetProfiler* _public) :
+	_this(_public)
+{
+
+}
+
+
+//============================================================================
+void DockWidgetProfilerPrivate::watch(QWidget* Widget, CDockWidget* DockWidget)
+{
+	if (WatchedObjects.contains(Widget))
+	{
+		return;
+	}
+
+	WatchedObjects.insert(Widget, DockWidget);
+	Widget->installEventFilter(_this);
+	QObject::connect(Widget, &QObject::destroyed, _this, [this](QObject* Object)
+	{
+		WatchedObjects.remove(Object);
+	});
+
+	for (auto Child : Widget->children())
+	{
+		if (Child->isWidgetType())
+		{
+			watch(static_cast<QWidget*>(Child), DockWidget);
+		}
+	}
+}
+
+
+//============================================================================
+int DockWidgetProfilerPrivate::eventCategory(QEvent::Type Type)
+{
+	switch (Type)
+	{
+	case QEvent::Paint: return CDockWidgetProfiler::PaintEvents;
+	case QEvent::Resize: return CDockWidgetProfiler::ResizeEvents;
+	case QEvent::LayoutRequest: return CDockWidgetProfiler::LayoutRequestEvents;
+	case QEvent::Show: return CDockWidgetProfiler::ShowEvents;
+	default: return -1;
+	}
+}
+
+
+//============================================================================
+void DockWidgetProfilerPrivate::addEventTime(CDockWidget* DockWidget, int Category,
+	qint64 Elapsed)
+{
+	auto EntryIt = Entries.find(DockWidget);
+	if (EntryIt != Entries.end())
+	{
+		EntryIt->Nanoseconds[Category] += Elapsed;
+		EntryIt->EventCount[Category]++;
+	}
+
+	if (EventBudget > 0 && Elapsed > qint64(EventBudget) * 1000)
+	{
+		emit _this->budgetExceeded(DockWidget, Category, Elapsed);
+	}
+}
+
+
+//============================================================================
+qint64 CDockWidgetProfiler::Entry::totalNanoseconds() const
+{
+	qint64 Total = 0;
+	for (auto Value : Nanoseconds)
+	{
+		Total += Value;
+	}
+	return Total;
+}
+
+
+//============================================================================
+CDockWidgetProfiler::CDockWidgetProfiler(CDockManager* DockManager) :
+	QObject(DockManager),
+	d(new DockWidgetProfilerPrivate(this))
+{
+	d->DockManager = DockManager;
+	StaticProfilers.append(this);
+	for (auto DockWidget : DockManager->dockWidgetsMap())
+	{
+		addDockWidget(DockWidget);
+	}
+}
+
+
+//============================================================================
+CDockWidgetProfiler::~CDockWidgetProfiler()
+{
+	StaticProfilers.removeAll(this);
+	for (auto it = d->WatchedObjects.begin(); it != d->WatchedObjects.end(); ++it)
+	{
+		it.key()->removeEventFilter(this);
+	}
+	delete d;
+}
+
+
+//============================================================================
+void CDockWidgetProfiler::addDockWidget(CDockWidget* DockWidget)
+{
+	auto& Entry = d->Entries[DockWidget];
+	Entry.DockWidget = DockWidget;
+	Entry.Name = DockWidget->objectName();
+	d->watch(DockWidget, DockWidget);
+}
+
+
+//============================================================================
+void CDockWidgetProfiler::removeDockWidget(CDockWidget* DockWidget)
+{
+	for (auto it = d->WatchedObjects.begin(); it != d->WatchedObjects.end();)
+	{
+		if (it.value() == DockWidget)
+		{
+			it.key()->removeEventFilter(this);
+			disconnect(it.key(), nullptr, this, nullptr);
+			it = d->WatchedObjects.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+
+//============================================================================
+bool CDockWidgetProfiler::eventFilter(QObject* Watched, QEvent* Event)
+{
+	// New child widgets like a new content widget are measured, too
+	if (Event->type() == QEvent::ChildAdded)
+	{
+		QObject* Child = static_cast<QChildEvent*>(Event)->child();
+		CDockWidget* DockWidget = d->WatchedObjects.value(Watched);
+		if (DockWidget && Child->isWidgetType())
+		{
+			d->watch(static_cast<QWidget*>(Child), DockWidget);
+		}
+	}
+
+	return false;
+}
+
+
+//============================================================================
+bool CDockWidgetProfiler::notify(QObject* Receiver, QEvent* Event,
+	const std::function<bool()>& Deliver)
+{
+	// Nested events are included in the time of the outer event
+	int Category = DockWidgetProfilerPrivate::eventCategory(Event->type());
+	if (Category < 0 || StaticDispatchDepth > 0)
+	{
+		return Deliver();
+	}
+
+	QPointer<CDockWidgetProfiler> Profiler;
+	QPointer<CDockWidget> DockWidget;
+	for (auto StaticProfiler : StaticProfilers)
+	{
+		DockWidget = StaticProfiler->d->WatchedObjects.value(Receiver);
+		if (DockWidget)
+		{
+			Profiler = StaticProfiler;
+			break;
+		}
+	}
+
+	if (!DockWidget)
+	{
+		return Deliver();
+	}
+
+	QElapsedTimer Timer;
+	Timer.start();
+	StaticDispatchDepth++;
+	bool Result = Deliver();
+	StaticDispatchDepth--;
+	qint64 Elapsed = Timer.nsecsElapsed();
+
+	// The event handling may delete the dock widget or the profiler
+	if (Profiler && DockWidget)
+	{
+		Profiler->d->addEventTime(DockWidget, Category, Elapsed);
+	}
+	return Result;
+}
+
+
+//============================================================================
+QVector<CDockWidgetProfiler::Entry> CDockWidgetProfiler::report() const
+{
+	QVector<Entry> Result;
+	Result.reserve(d->Entries.count());
+	for (const auto& Entry : d->Entries)
+	{
+		Result.append(Entry);
+	}
+	std::sort(Result.begin(), Result.end(), [](const Entry& a, const Entry& b)
+	{
+		return a.totalNanoseconds() > b.totalNanoseconds();
+	});
+	return Result;
+}
+
+
+//============================================================================
+QString CDockWidgetProfiler::reportText() const
+{
+	QString Text;
+	QTextStream s(&Text);
+	s << "dock widget";
+	for (auto Name : CategoryNames)
+	{
+		s << "\t" << Name << " ms";
+	}
+	s << "\ttotal ms\n";
+	for (const auto& Entry : report())
+	{
+		s << Entry.Name;
+		for (int i = 0; i < EventCategoryCount; ++i)
+		{
+			s << "\t" << QString::number(Entry.Nanoseconds[i] / 1e6, 'f', 2)
+			  << " (" << Entry.EventCount[i] << ")";
+		}
+		s << "\t" << QString::number(Entry.totalNanoseconds() / 1e6, 'f', 2) << "\n";
+	}
+	return Text;
+}
+
+
+//============================================================================
+void CDockWidgetProfiler::reset()
+{
+	for (auto it = d->Entries.begin(); it != d->Entries.end();)
+	{
+		if (!it->DockWidget)
+		{
+			it = d->Entries.erase(it);
+			continue;
+		}
+
+		*it = Entry{it->DockWidget, it->Name};
+		++it;
+	}
+}
+
+
+//============================================================================
+void CDockWidgetProfiler::setEventBudget(int Microseconds)
+{
+	d->EventBudget = qMax(0, Microseconds);
+}
+
+
+//============================================================================
+int CDockWidgetProfiler::eventBudget() const
+{
+	return d->EventBudget;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockWidgetProfiler.cpp
@@ -0,0 +1,175 @@
+#ifndef DockWidgetProfilerH
+#define DockWidgetProfilerH
+/*******************************************************************************
+** Qt Advanced Docking System
+** Copyright (C) 2017 Uwe Kindler
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+//============================================================================
+/// \file   DockWidgetProfiler.h
+/// \date   19.10.2026
+/// \brief  Declaration of CDockWidgetProfiler class
+//============================================================================
+
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <functional>
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+#include "ads_globals.h"
+
+namespace ads
+{
+struct DockWidgetProfilerPrivate;
+class CDockManager;
+class CDockWidget;
+
+/**
+ * Opt-in profiler that measures the time each dock widget spends in
+ * paint, resize, layout request and show events.
+ * If the profiler is enabled via CDockManager::setProfilingEnabled(), it
+ * tracks each dock widget that is registered in the dock manager and all
+ * child widgets of the dock widget including the content widget.
+ * An event filter only sees the start of the event handling. Therefore
+ * the time is measured by the static notify() function, that the
+ * application calls from its QApplication::notify() reimplementation:
+ * \code
+ * bool CApplication::notify(QObject* Receiver, QEvent* Event)
+ * {
+ *     return ads::CDockWidgetProfiler::notify(Receiver, Event,
+ *         [&]() {return QApplication::notify(Receiver, Event);});
+ * }
+ * \endcode
+ * If the application does not install this hook, no times are measured.
+ * Events that are sent while a measured event is handled are included in
+ * the time of the outer event.
+ */
+class ADS_EXPORT CDockWidgetProfiler : public QObject
+{
+	Q_OBJECT
+private:
+	DockWidgetProfilerPrivate* d; ///< private data (pimpl)
+	friend struct DockWidgetProfilerPrivate;
+	friend class CDockManager;
+
+protected:
+	/**
+	 * Creates the profiler for the given dock manager.
+	 * Use CDockManager::setProfilingEnabled() to create the profiler
+	 */
+	CDockWidgetProfiler(CDockManager* DockManager);
+
+	/**
+	 * Starts measuring the events of the given dock widget
+	 */
+	void addDockWidget(CDockWidget* DockWidget);
+
+	/**
+	 * Stops measuring the events of the given dock widget
+	 */
+	void removeDockWidget(CDockWidget* DockWidget);
+
+	virtual bool eventFilter(QObject* Watched, QEvent* Event) override;
+
+public:
+	/**
+	 * The measured event categories
+	 */
+	enum eEventCategory
+	{
+		PaintEvents,
+		ResizeEvents,
+		LayoutRequestEvents,
+		ShowEvents,
+		EventCategoryCount
+	};
+
+	/**
+	 * The accumulated times of a single dock widget
+	 */
+	struct Entry
+	{
+		QPointer<CDockWidget> DockWidget; ///< nullptr if the widget has been deleted
+		QString Name; ///< object name of the dock widget
+		qint64 Nanoseconds[EventCategoryCount] = {};
+		int EventCount[EventCategoryCount] = {};
+
+		/**
+		 * Returns the time spent in all event categories
+		 */
+		qint64 totalNanoseconds() const;
+	};
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CDockWidgetProfiler();
+
+	/**
+	 * Delivers the given event via the Deliver function and attributes the
+	 * time spent in Deliver to the measured dock widget the receiver
+	 * belongs to. Returns the result of Deliver.
+	 * Call this function from your QApplication::notify() reimplementation.
+	 */
+	static bool notify(QObject* Receiver, QEvent* Event,
+		const std::function<bool()>& Deliver);
+
+	/**
+	 * Returns the accumulated times of all measured dock widgets sorted by
+	 * the total time - the most expensive dock widget is the first entry
+	 */
+	QVector<Entry> report() const;
+
+	/**
+	 * Returns the report as human readable text table
+	 */
+	QString reportText() const;
+
+	/**
+	 * Clears all accumulated times
+	 */
+	void reset();
+
+	/**
+	 * Sets the time budget for the handling of a single event in
+	 * microseconds. If handling an event takes longer, budgetExceeded() is
+	 * emitted. A value of 0 disables the budget check.
+	 */
+	void setEventBudget(int Microseconds);
+
+	/**
+	 * Returns the event budget in microseconds
+	 */
+	int eventBudget() const;
+
+signals:
+	/**
+	 * This signal is emitted, if handling a single event of the given dock
+	 * widget took longer than the event budget
+	 */
+	void budgetExceeded(ads::CDockWidget* DockWidget, int Category, qint64 Nanoseconds);
+}; // class CDockWidgetProfiler
+} // namespace ads
+
+//-----------------------------------------------------------------------------
+#endif // DockWidgetProfilerH
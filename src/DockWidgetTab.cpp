@@ -177,15 +177,8 @@ void DockWidgetTabPrivate::createLayout()
 
 	CloseButton = createCloseButton();
 	CloseButton->setObjectName("tabCloseButton");
-	QIcon CloseIcon = CDockManager::iconProvider().customIcon(TabCloseIcon);
-	if (CloseIcon.isNull())
-	{
-		// The standard icons do does not look good on high DPI screens
-		QPixmap normalPixmap = _this->style()->standardPixmap(QStyle::SP_TitleBarCloseButton, 0, CloseButton);
-		CloseIcon.addPixmap(normalPixmap, QIcon::Normal);
-		CloseIcon.addPixmap(internal::createTransparentPixmap(normalPixmap, 0.25), QIcon::Disabled);
-	}
-	CloseButton->setIcon(CloseIcon);
+	CloseButton->setIcon(CDockManager::iconProvider().buttonIcon(TabCloseIcon,
+		QStyle::SP_TitleBarCloseButton, CloseButton));
     CloseButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
     _this->onDockWidgetFeaturesChanged();
 #ifndef QT_NO_TOOLTIP
@@ -227,6 +220,11 @@ void DockWidgetTabPrivate::moveTab(QMouseEvent* ev)
 bool DockWidgetTabPrivate::startFloating(eDragState DraggingState)
 {
 	auto dockContainer = DockWidget->dockContainer();
+	auto FloatingContainer = dockContainer->floatingWidget();
+	if (FloatingContainer && FloatingContainer->isDropPending())
+	{
+		return false;
+	}
     ADS_PRINT("isFloating " << dockContainer->isFloating());
     ADS_PRINT("areaCount " << dockContainer->dockAreaCount());
     ADS_PRINT("widgetCount " << DockWidget->dockAreaWidget()->dockWidgetsCount());
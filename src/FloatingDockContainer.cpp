@@ -36,12 +36,14 @@
 #include <QDebug>
 #include <QAbstractButton>
 #include <QElapsedTimer>
+#include <QTimer>
 
 #include "DockContainerWidget.h"
 #include "DockAreaWidget.h"
 #include "DockManager.h"
 #include "DockWidget.h"
 #include "DockOverlay.h"
+#include "DockLayoutJournal.h"
 
 #ifdef Q_OS_LINUX
 #include "linux/FloatingWidgetTitleBar.h"
@@ -51,6 +53,9 @@
 namespace ads
 {
 static unsigned int zOrderCounter = 0;
+/// Maximum time in milliseconds to wait for the window system to confirm
+/// the geometry of a floating widget
+static const int GeometryConfirmationTimeout = 100;
 /**
  * Private data class of CFloatingDockContainer class (pimpl)
  */
@@ -64,9 +69,17 @@ struct FloatingDockContainerPrivate
 	QPoint DragStartMousePosition;
 	CDockContainerWidget *DropContainer = nullptr;
 	CDockAreaWidget *SingleDockArea = nullptr;
+	QByteArray PendingGeometry; ///< restored geometry not applied until first show
+	QTimer* ConfirmationTimer = nullptr; ///< bounded wait for a Move or Resize confirmation
+	QRect PendingFrameGeometry; ///< frame geometry applied once the frame size is known
+	QPointer<CDockContainerWidget> PendingDropContainer;
+	QPointer<CDockAreaWidget> PendingDropTarget;
+	bool PendingDropHasTarget = false;
+	DockWidgetArea PendingDropArea = InvalidDockWidgetArea;
 #ifdef Q_OS_LINUX
     QWidget* MouseEventHandler = nullptr;
-    CFloatingWidgetTitleBar* TitleBar = nullptr;
+    CFloatingWidgetTitleBar* TitleBar = nullptr; ///< created on first show
+    QString WindowTitle;
 #endif
 
 	/**
@@ -77,6 +90,11 @@ struct FloatingDockContainerPrivate
 	void titleMouseReleaseEvent();
 	void updateDropOverlays(const QPoint &GlobalPos);
 
+	/**
+	 * Adds the current geometry of the floating widget to the layout journal
+	 */
+	void recordGeometry();
+
 	/**
 	 * Tests is a certain state is active
 	 */
@@ -85,19 +103,104 @@ struct FloatingDockContainerPrivate
 		return StateId == DraggingState;
 	}
 
+	/**
+	 * Sets the drag state.
+	 * We need an application wide event filter to detect mouse release
+	 * events because we do not receive mouse release event if the floating
+	 * widget is behind the drop overlay cross. The filter is only installed
+	 * while the floating widget is dragged, so that the events of all other
+	 * widgets do not pass through the filter of each floating container.
+	 */
 	void setState(eDragState StateId)
 	{
+		if (StateId == DraggingState)
+		{
+			return;
+		}
+
+		if (DraggingFloatingWidget == StateId)
+		{
+			qApp->installEventFilter(_this);
+		}
+		else if (DraggingFloatingWidget == DraggingState)
+		{
+			qApp->removeEventFilter(_this);
+		}
+		else if (DropPending == DraggingState)
+		{
+			PendingDropContainer.clear();
+			PendingDropTarget.clear();
+			if (ConfirmationTimer && !PendingFrameGeometry.isValid())
+			{
+				ConfirmationTimer->stop();
+			}
+		}
 		DraggingState = StateId;
 	}
 
+	/**
+	 * Starts the bounded wait for the window system to confirm the geometry
+	 * of the floating widget. The pending changes are applied in the event
+	 * loop pass after the first Move or Resize event or when the
+	 * GeometryConfirmationTimeout expires.
+	 */
+	void waitForGeometryConfirmation(int Timeout = GeometryConfirmationTimeout);
+
+	/**
+	 * Called from the Move and Resize events to apply the pending changes
+	 */
+	void confirmGeometry()
+	{
+		if (ConfirmationTimer && ConfirmationTimer->isActive())
+		{
+			ConfirmationTimer->start(0);
+		}
+	}
+
+	/**
+	 * Applies the pending frame geometry and the pending drop
+	 */
+	void applyPendingChanges();
+
 	void setWindowTitle(const QString &Text)
 	{
 #ifdef Q_OS_LINUX
-        TitleBar->setTitle(Text);
+		WindowTitle = Text;
+		if (TitleBar)
+		{
+			TitleBar->setTitle(Text);
+		}
 #else
 		_this->setWindowTitle(Text);
 #endif
 	}
+
+	/**
+	 * Updates the close button of the title bar if the title bar has
+	 * already been created
+	 */
+	void updateCloseButton()
+	{
+#ifdef Q_OS_LINUX
+		if (TitleBar)
+		{
+			TitleBar->enableCloseButton(_this->isClosable());
+		}
+#endif
+	}
+
+	/**
+	 * Creates the parts of the window that are only required if the floating
+	 * widget becomes visible. Floating widgets that are restored with closed
+	 * dock widgets stay hidden and never create them.
+	 */
+	void prepareFirstShow();
+
+	/**
+	 * Releases the native window and its backing store if the floating
+	 * widget is still hidden. The window is recreated on the next show.
+	 */
+	void releaseNativeWindow();
 };
 // struct FloatingDockContainerPrivate
 
@@ -109,6 +212,110 @@ FloatingDockContainerPrivate::FloatingDockContainerPrivate(
 
 }
 
+//============================================================================
+void FloatingDockContainerPrivate::prepareFirstShow()
+{
+#ifdef Q_OS_LINUX
+	if (!TitleBar)
+	{
+		TitleBar = new CFloatingWidgetTitleBar(_this);
+		TitleBar->setTitle(WindowTitle);
+		TitleBar->enableCloseButton(_this->isClosable());
+		_this->setTitleBarWidget(TitleBar);
+		_this->connect(TitleBar, SIGNAL(closeRequested()), SLOT(close()));
+	}
+#endif
+
+	if (!PendingGeometry.isEmpty())
+	{
+		_this->restoreGeometry(PendingGeometry);
+		PendingGeometry.clear();
+	}
+}
+
+
+//============================================================================
+void FloatingDockContainerPrivate::waitForGeometryConfirmation(int Timeout)
+{
+	if (!ConfirmationTimer)
+	{
+		ConfirmationTimer = new QTimer(_this);
+		ConfirmationTimer->setSingleShot(true);
+		QObject::connect(ConfirmationTimer, &QTimer::timeout, _this,
+			[this]() {applyPendingChanges();});
+	}
+	ConfirmationTimer->start(Timeout);
+}
+
+
+//============================================================================
+void FloatingDockContainerPrivate::applyPendingChanges()
+{
+	if (PendingFrameGeometry.isValid())
+	{
+		QRect Geometry = PendingFrameGeometry;
+		PendingFrameGeometry = QRect();
+		int FrameHeight = _this->frameGeometry().height() - _this->geometry().height();
+		Geometry.adjust(0, FrameHeight, 0, 0);
+		_this->setGeometry(Geometry);
+	}
+
+	if (!isState(DropPending))
+	{
+		return;
+	}
+
+	QPointer<CDockContainerWidget> Container = PendingDropContainer;
+	QPointer<CDockAreaWidget> Target = PendingDropTarget;
+	bool TargetValid = Target || !PendingDropHasTarget;
+	auto DropArea = PendingDropArea;
+	setState(DraggingInactive);
+	if (!Container || !TargetValid || !DockManager || DockManager->isRestoringState())
+	{
+		ADS_PRINT("CFloatingDockContainer pending drop dropped, target is gone");
+		return;
+	}
+	Container->dropFloatingWidget(_this, DropArea, Target);
+}
+
+
+//============================================================================
+void FloatingDockContainerPrivate::releaseNativeWindow()
+{
+	if (!_this->isHidden() || !_this->testAttribute(Qt::WA_WState_Created))
+	{
+		return;
+	}
+
+	ADS_PRINT("CFloatingDockContainer releases native window");
+	// destroy() deletes the platform window and the backing store of this
+	// top level widget and all native children. The geometry is applied
+	// again when the window is recreated on the next show
+	PendingGeometry = _this->saveGeometry();
+	_this->destroy();
+}
+
+
+//============================================================================
+void FloatingDockContainerPrivate::recordGeometry()
+{
+	CLayoutJournalScope JournalScope(DockManager);
+	if (!JournalScope.isActive() || !_this->isVisible())
+	{
+		return;
+	}
+
+	auto DockWidgets = DockContainer->dockWidgets();
+	if (DockWidgets.isEmpty())
+	{
+		return;
+	}
+
+	JournalScope.record(CDockLayoutJournal::FloatingGeometryChanged,
+		{DockWidgets.first()->objectName(), QString::fromLatin1(_this->savedGeometry().toHex())});
+}
+
+
 //============================================================================
 void FloatingDockContainerPrivate::titleMouseReleaseEvent()
 {
@@ -123,6 +330,10 @@ void FloatingDockContainerPrivate::titleMouseReleaseEvent()
 	    || DockManager->containerOverlay()->dropAreaUnderCursor()
 	        != InvalidDockWidgetArea)
 	{
+		// Resolve the drop target now, while the drop overlays are visible
+		CDockAreaWidget* TargetArea;
+		auto DropArea = DropContainer->floatingWidgetDropArea(QCursor::pos(), TargetArea);
+
 		// Resize the floating widget to the size of the highlighted drop area
 		// rectangle
 		CDockOverlay *Overlay = DockManager->containerOverlay();
@@ -136,6 +347,21 @@ void FloatingDockContainerPrivate::titleMouseReleaseEvent()
 		    / 2;
 		int TitleBarHeight = _this->frameSize().height()
 		    - _this->rect().height() - FrameWidth;
+
+		// The drop is applied when the window system has confirmed the new
+		// geometry with a Move or Resize event. We enter the DropPending
+		// state before the geometry is set, because some platforms confirm
+		// the geometry synchronously
+		if (DropArea != InvalidDockWidgetArea)
+		{
+			setState(DropPending);
+			PendingDropContainer = DropContainer;
+			PendingDropTarget = TargetArea;
+			PendingDropHasTarget = (TargetArea != nullptr);
+			PendingDropArea = DropArea;
+			waitForGeometryConfirmation(Rect.isValid() ? GeometryConfirmationTimeout : 0);
+		}
+
 		if (Rect.isValid())
 		{
 			QPoint TopLeft = Overlay->mapToGlobal(Rect.topLeft());
@@ -143,9 +369,7 @@ void FloatingDockContainerPrivate::titleMouseReleaseEvent()
 			_this->setGeometry(
 			    QRect(TopLeft,
 			        QSize(Rect.width(), Rect.height() - TitleBarHeight)));
-			QApplication::processEvents();
 		}
-		DropContainer->dropFloatingWidget(_this, QCursor::pos());
 	}
 
 	DockManager->containerOverlay()->hideOverlay();
@@ -160,7 +384,7 @@ void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
 		return;
 	}
 
-	auto Containers = DockManager->dockContainers();
+	const auto& Containers = DockManager->dockContainers();
 	CDockContainerWidget *TopContainer = nullptr;
 	for (auto ContainerWidget : Containers)
 	{
@@ -242,13 +466,12 @@ CFloatingDockContainer::CFloatingDockContainer(CDockManager *DockManager) :
 	    SLOT(onDockAreasAddedOrRemoved()));
 
 #ifdef Q_OS_LINUX
-    d->TitleBar = new CFloatingWidgetTitleBar(this);
+    // The title bar is created in setVisible() when the widget is shown
+    // for the first time
     setWindowFlags(windowFlags() | Qt::Tool);
     QDockWidget::setWidget(d->DockContainer);
     QDockWidget::setFloating(true);
     QDockWidget::setFeatures(QDockWidget::AllDockWidgetFeatures);
-    setTitleBarWidget(d->TitleBar);
-    connect(d->TitleBar, SIGNAL(closeRequested()), SLOT(close()));
 #else
 	setWindowFlags(
 	    Qt::Window | Qt::WindowMaximizeButtonHint | Qt::WindowCloseButtonHint);
@@ -260,21 +483,32 @@ CFloatingDockContainer::CFloatingDockContainer(CDockManager *DockManager) :
 #endif
 
 	DockManager->registerFloatingWidget(this);
-
-	// We install an event filter to detect mouse release events because we
-	// do not receive mouse release event if the floating widget is behind
-	// the drop overlay cross
-	qApp->installEventFilter(this);
+	// A restore replaces the layout the pending drop refers to
+	connect(DockManager, &CDockManager::restoringState, this, [this]()
+	{
+		if (d->isState(DropPending))
+		{
+			d->setState(DraggingInactive);
+		}
+	});
 }
 
 //============================================================================
 CFloatingDockContainer::CFloatingDockContainer(CDockAreaWidget *DockArea) :
 	CFloatingDockContainer(DockArea->dockManager())
 {
+	CLayoutJournalScope JournalScope(d->DockManager);
+	if (JournalScope.isActive())
+	{
+		auto Anchor = CLayoutJournalScope::areaAnchor(DockArea);
+		if (Anchor.isEmpty())
+		{
+			JournalScope.invalidate();
+		}
+		JournalScope.record(CDockLayoutJournal::DockAreaFloated, {Anchor});
+	}
 	d->DockContainer->addDockArea(DockArea);
-#ifdef Q_OS_LINUX
-    d->TitleBar->enableCloseButton(isClosable());
-#endif
+    d->updateCloseButton();
     auto TopLevelDockWidget = topLevelDockWidget();
     if (TopLevelDockWidget)
     {
@@ -286,10 +520,13 @@ CFloatingDockContainer::CFloatingDockContainer(CDockAreaWidget *DockArea) :
 CFloatingDockContainer::CFloatingDockContainer(CDockWidget *DockWidget) :
 	CFloatingDockContainer(DockWidget->dockManager())
 {
+	CLayoutJournalScope JournalScope(d->DockManager);
+	if (JournalScope.isActive())
+	{
+		JournalScope.record(CDockLayoutJournal::DockWidgetFloated, {DockWidget->objectName()});
+	}
 	d->DockContainer->addDockWidget(CenterDockWidgetArea, DockWidget);
-#ifdef Q_OS_LINUX
-    d->TitleBar->enableCloseButton(isClosable());
-#endif
+    d->updateCloseButton();
     auto TopLevelDockWidget = topLevelDockWidget();
     if (TopLevelDockWidget)
     {
@@ -318,6 +555,11 @@ CDockContainerWidget* CFloatingDockContainer::dockContainer() const
 void CFloatingDockContainer::changeEvent(QEvent *event)
 {
 	QWidget::changeEvent(event);
+	if (event->type() == QEvent::WindowStateChange && d->DockManager)
+	{
+		d->DockManager->scheduleOcclusionUpdate();
+	}
+
 	if ((event->type() == QEvent::ActivationChange) && isActiveWindow())
 	{
 		ADS_PRINT("FloatingWidget::changeEvent QEvent::ActivationChange ");
@@ -343,6 +585,28 @@ void CFloatingDockContainer::moveEvent(QMoveEvent *event)
 	default:
 		break;
 	}
+
+	d->confirmGeometry();
+	if (d->DockManager)
+	{
+		d->DockManager->markLayoutDirty();
+		d->DockManager->scheduleOcclusionUpdate();
+		d->recordGeometry();
+	}
+}
+
+
+//============================================================================
+void CFloatingDockContainer::resizeEvent(QResizeEvent *event)
+{
+	tFloatingWidgetBase::resizeEvent(event);
+	d->confirmGeometry();
+	if (d->DockManager)
+	{
+		d->DockManager->markLayoutDirty();
+		d->DockManager->scheduleOcclusionUpdate();
+		d->recordGeometry();
+	}
 }
 
 //============================================================================
@@ -390,11 +654,22 @@ void CFloatingDockContainer::closeEvent(QCloseEvent *event)
 void CFloatingDockContainer::hideEvent(QHideEvent *event)
 {
 	Super::hideEvent(event);
+	if (d->DockManager)
+	{
+		d->DockManager->scheduleOcclusionUpdate();
+	}
     if (event->spontaneous())
     {
         return;
     }
 
+    if (CDockManager::configFlags().testFlag(CDockManager::FloatingContainerReleasesNativeWindow))
+    {
+    	// Deferred because the widget may be shown again immediately, e.g.
+    	// while the dock manager restores a state
+    	QTimer::singleShot(0, this, [this]() {d->releaseNativeWindow();});
+    }
+
     // Prevent toogleView() events during restore state
     if (d->DockManager->isRestoringState())
     {
@@ -410,10 +685,24 @@ void CFloatingDockContainer::hideEvent(QHideEvent *event)
 	}
 }
 
+//============================================================================
+void CFloatingDockContainer::setVisible(bool Visible)
+{
+	if (Visible)
+	{
+		d->prepareFirstShow();
+	}
+	tFloatingWidgetBase::setVisible(Visible);
+}
+
 //============================================================================
 void CFloatingDockContainer::showEvent(QShowEvent *event)
 {
 	Super::showEvent(event);
+	if (d->DockManager)
+	{
+		d->DockManager->scheduleOcclusionUpdate();
+	}
 }
 
 //============================================================================
@@ -483,6 +772,9 @@ bool CFloatingDockContainer::event(QEvent *e)
 		}
 		break;
 
+	// Mouse presses on the title bar do not start a new drag operation
+	// while the drop of this widget is pending
+	case DropPending:
 	default:
 		break;
 	}
@@ -515,6 +807,11 @@ void CFloatingDockContainer::startFloating(const QPoint &DragStartMousePos,
 #ifndef Q_OS_LINUX
 	Q_UNUSED(MouseEventHandler)
 #endif
+	if (d->isState(DropPending))
+	{
+		ADS_PRINT("CFloatingDockContainer::startFloating rejected, drop pending");
+		return;
+	}
 	resize(Size);
 	d->setState(DragState);
 	d->DragStartMousePosition = DragStartMousePos;
@@ -608,6 +905,35 @@ bool CFloatingDockContainer::restoreState(CDockingStateReader &Stream,
 	return true;
 }
 
+
+//============================================================================
+void CFloatingDockContainer::restoreState(const CDockLayoutModel& Model,
+	int ContainerIndex, const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas)
+{
+	d->DockContainer->restoreState(Model, ContainerIndex, PrebuiltDockAreas);
+	onDockAreasAddedOrRemoved();
+}
+
+//============================================================================
+void CFloatingDockContainer::restoreGeometryDeferred(const QByteArray& Geometry)
+{
+	if (isVisible())
+	{
+		d->PendingGeometry.clear();
+		restoreGeometry(Geometry);
+	}
+	else
+	{
+		d->PendingGeometry = Geometry;
+	}
+}
+
+//============================================================================
+QByteArray CFloatingDockContainer::savedGeometry() const
+{
+	return d->PendingGeometry.isEmpty() ? saveGeometry() : d->PendingGeometry;
+}
+
 //============================================================================
 bool CFloatingDockContainer::hasTopLevelDockWidget() const
 {
@@ -626,6 +952,21 @@ QList<CDockWidget*> CFloatingDockContainer::dockWidgets() const
 	return d->DockContainer->dockWidgets();
 }
 
+//============================================================================
+bool CFloatingDockContainer::isDropPending() const
+{
+	return d->isState(DropPending);
+}
+
+
+//============================================================================
+void CFloatingDockContainer::fitFrameGeometry(const QRect& Geometry)
+{
+	d->PendingFrameGeometry = Geometry;
+	d->waitForGeometryConfirmation();
+}
+
+
 //============================================================================
 void CFloatingDockContainer::finishDragging()
 {
@@ -32,6 +32,7 @@
 #include "ads_globals.h"
 
 #include <QRubberBand>
+#include <QHash>
 
 #ifdef Q_OS_LINUX
 #include <QDockWidget>
@@ -59,6 +60,7 @@ class CDockAreaTitleBar;
 struct DockAreaTitleBarPrivate;
 class CFloatingWidgetTitleBar;
 class CDockingStateReader;
+class CDockLayoutModel;
 
 /**
  * Pure virtual interface for floating widgets
@@ -99,6 +101,20 @@ private:
 	friend class CDockWidget;
 	friend class CDockAreaWidget;
     friend class CFloatingWidgetTitleBar;
+    friend class CFloatingOverlay;
+
+	/**
+	 * Returns true, if the floating widget has been released over a drop
+	 * area and the drop is not applied yet. No new drag operation may
+	 * be started while a drop is pending.
+	 */
+	bool isDropPending() const;
+
+	/**
+	 * Sets the frame geometry of the window to the given rectangle as soon
+	 * as the window system has reported the size of the window frame
+	 */
+	void fitFrameGeometry(const QRect& Geometry);
 
 private slots:
 	void onDockAreasAddedOrRemoved();
@@ -151,6 +167,12 @@ protected:
 	 */
 	bool restoreState(CDockingStateReader& Stream, bool Testing);
 
+	/**
+	 * Restores the container with the given index from the layout model
+	 */
+	void restoreState(const CDockLayoutModel& Model, int ContainerIndex,
+		const QHash<int, CDockAreaWidget*>& PrebuiltDockAreas = QHash<int, CDockAreaWidget*>());
+
 	/**
 	 * Call this function to update the window title
 	 */
@@ -160,6 +182,7 @@ protected:
 protected: // reimplements QWidget
 	virtual void changeEvent(QEvent *event) override;
 	virtual void moveEvent(QMoveEvent *event) override;
+	virtual void resizeEvent(QResizeEvent *event) override;
 	virtual bool event(QEvent *e) override;
 	virtual void closeEvent(QCloseEvent *event) override;
 	virtual void hideEvent(QHideEvent *event) override;
@@ -189,6 +212,11 @@ public:
 	 */
 	virtual ~CFloatingDockContainer();
 
+	/**
+	 * Applies the deferred native window setup before the first show
+	 */
+	virtual void setVisible(bool Visible) override;
+
 	/**
 	 * Access function for the internal dock container
 	 */
@@ -221,6 +249,20 @@ public:
      * function of the internal container widget.
      */
     QList<CDockWidget*> dockWidgets() const;
+
+    /**
+     * Restores the given geometry. If the floating widget is hidden, the
+     * geometry is stored and applied when the widget is shown for the first
+     * time. So floating widgets that stay hidden after a state restore never
+     * need a native window.
+     */
+    void restoreGeometryDeferred(const QByteArray& Geometry);
+
+    /**
+     * Returns the geometry like saveGeometry() does or the geometry passed
+     * to restoreGeometryDeferred() if it has not been applied yet
+     */
+    QByteArray savedGeometry() const;
 }; // class FloatingDockContainer
 }
  // namespace ads
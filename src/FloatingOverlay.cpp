@@ -15,6 +15,8 @@
 #include <QEvent>
 #include <QApplication>
 #include <QPainter>
+#include <QPointer>
+#include <QTimer>
 
 #include "DockWidget.h"
 #include "DockAreaWidget.h"
@@ -41,6 +43,8 @@ struct FloatingOverlayPrivate
 	bool Hidden = false;
 	bool IgnoreMouseEvents = false;
 	QPixmap ContentPreviewPixmap;
+	QRect ContentPreviewRect;
+	QPointer<CDockWidget> PreviewDockWidget;
 
 
 	/**
@@ -54,6 +58,18 @@ struct FloatingOverlayPrivate
 		Hidden = Value;
 		_this->update();
 	}
+
+	/**
+	 * Uses the cached preview pixmap of the dock widget until the current
+	 * content has been rendered
+	 */
+	void createContentPreviewPixmap();
+
+	/**
+	 * Renders the current content, if the cached pixmap is missing or
+	 * outdated, and replaces the shown pixmap
+	 */
+	void renderContentPreviewPixmap();
 };
 // struct LedArrayPanelPrivate
 
@@ -66,7 +82,7 @@ void FloatingOverlayPrivate::updateDropOverlays(const QPoint &GlobalPos)
 		return;
 	}
 
-	auto Containers = DockManager->dockContainers();
+	const auto& Containers = DockManager->dockContainers();
 	CDockContainerWidget *TopContainer = nullptr;
 	for (auto ContainerWidget : Containers)
 	{
@@ -151,6 +167,46 @@ void FloatingOverlayPrivate::updateDropOverlays(const QPoint &GlobalPos)
 }
 
 
+//============================================================================
+void FloatingOverlayPrivate::createContentPreviewPixmap()
+{
+	// For a dock area we show the preview of the current dock widget.
+	// The title bar area is covered by the placeholder frame
+	PreviewDockWidget = qobject_cast<CDockWidget*>(Content);
+	if (!PreviewDockWidget)
+	{
+		auto DockArea = qobject_cast<CDockAreaWidget*>(Content);
+		PreviewDockWidget = DockArea ? DockArea->currentDockWidget() : nullptr;
+	}
+
+	if (!PreviewDockWidget)
+	{
+		return;
+	}
+
+	QPoint Offset = (PreviewDockWidget.data() == Content) ? QPoint(0, 0)
+		: PreviewDockWidget->mapTo(Content, QPoint(0, 0));
+	ContentPreviewRect = QRect(Offset, PreviewDockWidget->size());
+	// Rendering the content may take some time - so we show the cached
+	// pixmap or the placeholder first and render the current content when
+	// the drag preview is visible - see showEvent()
+	ContentPreviewPixmap = PreviewDockWidget->previewPixmap();
+}
+
+
+//============================================================================
+void FloatingOverlayPrivate::renderContentPreviewPixmap()
+{
+	if (!PreviewDockWidget)
+	{
+		return;
+	}
+
+	ContentPreviewPixmap = PreviewDockWidget->renderPreviewPixmap();
+	_this->update();
+}
+
+
 //============================================================================
 FloatingOverlayPrivate::FloatingOverlayPrivate(CFloatingOverlay *_public) :
 	_this(_public)
@@ -194,8 +250,7 @@ CFloatingOverlay::CFloatingOverlay(QWidget* Content, QWidget* parent) :
 	// operations
 	if (CDockManager::configFlags().testFlag(CDockManager::DragPreviewShowsContentPixmap))
 	{
-		d->ContentPreviewPixmap = QPixmap(Content->size());
-		Content->render(&d->ContentPreviewPixmap);
+		d->createContentPreviewPixmap();
 	}
 }
 
@@ -296,11 +351,9 @@ bool CFloatingOverlay::eventFilter(QObject *watched, QEvent *event)
 			FloatingWidget->show();
 			if (!CDockManager::configFlags().testFlag(CDockManager::DragPreviewHasWindowFrame))
 			{
-				QApplication::processEvents();
-				int FrameHeight = FloatingWidget->frameGeometry().height() - FloatingWidget->geometry().height();
-				QRect FixedGeometry = this->geometry();
-				FixedGeometry.adjust(0, FrameHeight, 0, 0);
-				FloatingWidget->setGeometry(FixedGeometry);
+				// The window frame is known as soon as the window system
+				// has confirmed the geometry of the shown window
+				FloatingWidget->fitFrameGeometry(this->geometry());
 			}
 		}
 
@@ -311,12 +364,26 @@ bool CFloatingOverlay::eventFilter(QObject *watched, QEvent *event)
 		// events. To prevent multiple code execution, we ignore all mouse
 		// events after the first mouse event
 		d->IgnoreMouseEvents = true;
+		qApp->removeEventFilter(this);
 	}
 
 	return false;
 }
 
 
+//============================================================================
+void CFloatingOverlay::showEvent(QShowEvent *event)
+{
+	Super::showEvent(event);
+	if (d->PreviewDockWidget)
+	{
+		// The zero timer lets the drag preview paint itself before the
+		// content is rendered
+		QTimer::singleShot(0, this, [this]() {d->renderContentPreviewPixmap();});
+	}
+}
+
+
 //============================================================================
 void CFloatingOverlay::paintEvent(QPaintEvent* event)
 {
@@ -327,9 +394,11 @@ void CFloatingOverlay::paintEvent(QPaintEvent* event)
 	}
 
 	QPainter painter(this);
-	if (CDockManager::configFlags().testFlag(CDockManager::DragPreviewShowsContentPixmap))
+	if (CDockManager::configFlags().testFlag(CDockManager::DragPreviewShowsContentPixmap)
+	 && !d->ContentPreviewPixmap.isNull())
 	{
-		painter.drawPixmap(QPoint(0, 0), d->ContentPreviewPixmap);
+		painter.setRenderHint(QPainter::SmoothPixmapTransform);
+		painter.drawPixmap(d->ContentPreviewRect, d->ContentPreviewPixmap);
 	}
 
 	// If we do not have a window frame then we paint a QRubberBadn like
@@ -33,6 +33,7 @@ protected:
 	virtual void moveEvent(QMoveEvent *event) override;
 	virtual bool eventFilter(QObject *watched, QEvent *event) override;
 	virtual void paintEvent(QPaintEvent *e) override;
+	virtual void showEvent(QShowEvent *event) override;
 
 	/**
 	 * The content is a DockArea or a DockWidget
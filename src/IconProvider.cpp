@@ -10,6 +10,10 @@
 //============================================================================
 #include "IconProvider.h"
 #include <QVector>
+#include <QPointer>
+#include <QWidget>
+#include <QGuiApplication>
+#include <QScreen>
 
 namespace ads
 {
@@ -18,8 +22,19 @@ namespace ads
  */
 struct IconProviderPrivate
 {
+	/**
+	 * Standard icon that has been rasterized for a certain style
+	 */
+	struct CachedIcon
+	{
+		QPointer<QStyle> Style;
+		QStyle::StandardPixmap StandardPixmap;
+		QIcon Icon;
+	};
+
 	CIconProvider *_this;
 	QVector<QIcon> UserIcons{IconCount, QIcon()};
+	QVector<CachedIcon> IconCache;
 
 	/**
 	 * Private data constructor
@@ -64,6 +79,74 @@ void CIconProvider::registerCustomIcon(eIcon IconId, const QIcon &icon)
 	d->UserIcons[IconId] = icon;
 }
 
+
+//============================================================================
+QIcon CIconProvider::standardIcon(QStyle::StandardPixmap StandardPixmap,
+	const QWidget* Widget) const
+{
+	QStyle* Style = Widget->style();
+	// A destroyed style clears the QPointer, so a new style at the same
+	// address does not get the icons of the destroyed style
+	for (const auto& Entry : d->IconCache)
+	{
+		if (Entry.Style == Style && Entry.StandardPixmap == StandardPixmap)
+		{
+			return Entry.Icon;
+		}
+	}
+
+	// The widget may not be shown yet and does not know the screen it will
+	// be shown on. Therefore we rasterize the icon for the device pixel
+	// ratios of all screens and the icon selects the matching pixmap
+	QVector<qreal> DevicePixelRatios;
+	for (auto Screen : QGuiApplication::screens())
+	{
+		if (!DevicePixelRatios.contains(Screen->devicePixelRatio()))
+		{
+			DevicePixelRatios.append(Screen->devicePixelRatio());
+		}
+	}
+	if (DevicePixelRatios.isEmpty())
+	{
+		DevicePixelRatios.append(1.0);
+	}
+
+	QIcon StyleIcon = Style->standardIcon(StandardPixmap, 0, Widget);
+	int Extent = Style->pixelMetric(QStyle::PM_SmallIconSize, 0, Widget);
+	QIcon Icon;
+	for (auto DevicePixelRatio : DevicePixelRatios)
+	{
+		QPixmap NormalPixmap = StyleIcon.pixmap(QSize(Extent, Extent) * DevicePixelRatio);
+		if (NormalPixmap.isNull())
+		{
+			continue;
+		}
+		// The style may not provide a pixmap of the requested size. Smaller
+		// pixmaps are scaled down to the icon size or shown unscaled
+		NormalPixmap.setDevicePixelRatio(qMax(qreal(1), qreal(NormalPixmap.width()) / Extent));
+		Icon.addPixmap(NormalPixmap, QIcon::Normal);
+		Icon.addPixmap(internal::createTransparentPixmap(NormalPixmap, 0.25), QIcon::Disabled);
+	}
+	d->IconCache.append({Style, StandardPixmap, Icon});
+	return Icon;
+}
+
+
+//============================================================================
+QIcon CIconProvider::buttonIcon(eIcon IconId, QStyle::StandardPixmap StandardPixmap,
+	const QWidget* Widget) const
+{
+	QIcon Icon = customIcon(IconId);
+	return Icon.isNull() ? standardIcon(StandardPixmap, Widget) : Icon;
+}
+
+
+//============================================================================
+void CIconProvider::clearIconCache()
+{
+	d->IconCache.clear();
+}
+
 } // namespace ads
 
 
@@ -11,6 +11,7 @@
 //                                   INCLUDES
 //============================================================================
 #include <QIcon>
+#include <QStyle>
 
 #include "ads_globals.h"
 
@@ -24,6 +25,8 @@ struct IconProviderPrivate;
  * system.
  * The IconProvider enables the user to register custom icons in case using
  * stylesheets is not an option.
+ * The icons created from standard pixmaps of the style are cached, so that
+ * all buttons share the same pre-rasterized pixmaps.
  */
 class ADS_EXPORT CIconProvider
 {
@@ -52,6 +55,29 @@ public:
 	 * Registers a custom icon for the given IconId
 	 */
 	void registerCustomIcon(eIcon IconId, const QIcon &icon);
+
+	/**
+	 * Returns an icon with the given standard pixmap of the style of the
+	 * given widget and a transparent variant for the disabled state.
+	 * The pixmaps are rasterized only once for each style. The icon contains
+	 * one pixmap for each device pixel ratio of the available screens, so
+	 * that the shared icon is sharp on all screens.
+	 */
+	QIcon standardIcon(QStyle::StandardPixmap StandardPixmap, const QWidget* Widget) const;
+
+	/**
+	 * Returns the custom icon for the given IconId if one is registered and
+	 * the cached standardIcon() for the given standard pixmap otherwise
+	 */
+	QIcon buttonIcon(eIcon IconId, QStyle::StandardPixmap StandardPixmap,
+		const QWidget* Widget) const;
+
+	/**
+	 * Removes all cached standard icons. Call this function if the style
+	 * changed in a way that changes the standard pixmaps, e.g. if a new
+	 * application stylesheet has been set.
+	 */
+	void clearIconCache();
 }; // class IconProvider
 
 } // namespace ads
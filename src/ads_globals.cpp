@@ -32,6 +32,7 @@
 #include <QPainter>
 
 #include "DockSplitter.h"
+#include "DockContainerWidget.h"
 #include "ads_globals.h"
 
 
@@ -48,6 +49,24 @@ void replaceSplitterWidget(QSplitter* Splitter, QWidget* From, QWidget* To)
 	Splitter->insertWidget(index, To);
 }
 
+//============================================================================
+CDockContainerWidget* parentDockContainer(QWidget* Parent)
+{
+	if (!Parent)
+	{
+		return nullptr;
+	}
+
+	auto Splitter = qobject_cast<CDockSplitter*>(Parent);
+	if (Splitter)
+	{
+		return Splitter->dockContainer();
+	}
+
+	auto Container = qobject_cast<CDockContainerWidget*>(Parent);
+	return Container ? Container : findParent<CDockContainerWidget*>(Parent);
+}
+
 //============================================================================
 CDockInsertParam dockAreaInsertParameters(DockWidgetArea Area)
 {
@@ -69,6 +88,7 @@ CDockInsertParam dockAreaInsertParameters(DockWidgetArea Area)
 QPixmap createTransparentPixmap(const QPixmap& Source, qreal Opacity)
 {
 	QPixmap TransparentPixmap(Source.size());
+	TransparentPixmap.setDevicePixelRatio(Source.devicePixelRatio());
 	TransparentPixmap.fill(Qt::transparent);
 	QPainter p(&TransparentPixmap);
 	p.setOpacity(Opacity);
@@ -80,13 +100,18 @@ QPixmap createTransparentPixmap(const QPixmap& Source, qreal Opacity)
 //============================================================================
 void hideEmptyParentSplitters(CDockSplitter* Splitter)
 {
-	while (Splitter && Splitter->isVisible())
+	if (!Splitter || !Splitter->isVisible())
+	{
+		return;
+	}
+
+	// Hiding a splitter only changes the visible content of its parent
+	// splitter. So we can stop at the first splitter that still has
+	// visible content
+	while (Splitter && !Splitter->hasVisibleContent())
 	{
-		if (!Splitter->hasVisibleContent())
-		{
-			Splitter->hide();
-		}
-		Splitter = internal::findParent<CDockSplitter*>(Splitter);
+		Splitter->hide();
+		Splitter = qobject_cast<CDockSplitter*>(Splitter->parentWidget());
 	}
 }
 
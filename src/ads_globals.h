@@ -69,6 +69,7 @@ enum eStateFileVersion
 };
 
 class CDockSplitter;
+class CDockContainerWidget;
 
 enum DockWidgetArea
 {
@@ -101,7 +102,8 @@ enum eDragState
 	DraggingInactive,     //!< DraggingInactive
 	DraggingMousePressed, //!< DraggingMousePressed
 	DraggingTab,          //!< DraggingTab
-	DraggingFloatingWidget//!< DraggingFloatingWidget
+	DraggingFloatingWidget,//!< DraggingFloatingWidget
+	DropPending           //!< floating widget released over a drop area, waits for its geometry to be confirmed
 };
 
 /**
@@ -117,12 +119,113 @@ enum eIcon
 	IconCount,         //!< just a delimiter for range checks
 };
 
+/**
+ * Lightweight, non-owning view of the dock widgets of a dock area or of the
+ * dock areas of a dock container.
+ * The view does not allocate any memory - it iterates the items of its
+ * owner via index based access and skips all items that do not pass the
+ * optional filter. Use it in range based for loops instead of the list
+ * returning functions like openedDockWidgets() or openedDockAreas().
+ * The view is only valid as long as the owner exists and it must not be used
+ * while items are added to or removed from the owner.
+ */
+template <class tOwner, class tItem>
+class CWidgetView
+{
+public:
+	using tAccessor = tItem* (*)(const tOwner*, int);
+	using tFilter = bool (*)(const tItem*);
+
+	class const_iterator
+	{
+	private:
+		const CWidgetView* View;
+		int Index;
+
+		void skipFiltered()
+		{
+			while (Index < View->Count && !View->accepts(Index))
+			{
+				++Index;
+			}
+		}
+
+	public:
+		const_iterator(const CWidgetView* View, int Index)
+			: View(View), Index(Index)
+		{
+			skipFiltered();
+		}
+
+		tItem* operator*() const {return View->Accessor(View->Owner, Index);}
+		const_iterator& operator++() {++Index; skipFiltered(); return *this;}
+		bool operator==(const const_iterator& Other) const {return Index == Other.Index;}
+		bool operator!=(const const_iterator& Other) const {return Index != Other.Index;}
+	};
+
+	CWidgetView(const tOwner* Owner, int Count, tAccessor Accessor,
+		tFilter Filter = nullptr)
+		: Owner(Owner), Count(Count), Accessor(Accessor), Filter(Filter)
+	{}
+
+	const_iterator begin() const {return const_iterator(this, 0);}
+	const_iterator end() const {return const_iterator(this, Count);}
+
+	/**
+	 * Returns true, if no item passes the filter. Stops at the first item
+	 * that passes.
+	 */
+	bool isEmpty() const {return begin() == end();}
+
+	/**
+	 * Returns the number of items that pass the filter
+	 */
+	int count() const
+	{
+		int Result = 0;
+		for (auto it = begin(); it != end(); ++it)
+		{
+			++Result;
+		}
+		return Result;
+	}
+
+	/**
+	 * Returns true, if exactly one item passes the filter. Stops at the
+	 * second item that passes.
+	 */
+	bool hasSingleItem() const
+	{
+		auto it = begin();
+		return (it != end()) && (++it == end());
+	}
+
+	/**
+	 * Returns the first item that passes the filter or a nullptr
+	 */
+	tItem* first() const
+	{
+		auto it = begin();
+		return (it != end()) ? *it : nullptr;
+	}
+
+private:
+	const tOwner* Owner;
+	int Count;
+	tAccessor Accessor;
+	tFilter Filter;
+
+	bool accepts(int Index) const
+	{
+		return !Filter || Filter(Accessor(Owner, Index));
+	}
+}; // class CWidgetView
+
+
 namespace internal
 {
 static const bool RestoreTesting = true;
 static const bool Restore = false;
-static const char* const ClosedProperty = "close";
-static const char* const DirtyProperty = "dirty";
 
 /**
  * Replace the from widget in the given splitter with the To widget
@@ -135,6 +238,14 @@ void replaceSplitterWidget(QSplitter* Splitter, QWidget* From, QWidget* To);
  */
 void hideEmptyParentSplitters(CDockSplitter* FirstParentSplitter);
 
+/**
+ * Returns the dock container of a dock area or splitter whose parent is
+ * the given widget.
+ * If the parent is a dock splitter, its cached dock container is returned
+ * so the function does not need to walk up the widget hierarchy.
+ */
+CDockContainerWidget* parentDockContainer(QWidget* Parent);
+
 /**
  * Convenience class for QPair to provide better naming than first and
  * second
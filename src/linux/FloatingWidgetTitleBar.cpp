@@ -83,13 +83,6 @@ void FloatingWidgetTitleBarPrivate::createLayout()
 	CloseButton->setObjectName("floatingTitleCloseButton");
 	CloseButton->setFlat(true);
 
-	// The standard icons do does not look good on high DPI screens
-	QIcon CloseIcon;
-	QPixmap normalPixmap = _this->style()->standardPixmap(
-	    QStyle::SP_TitleBarCloseButton, 0, CloseButton);
-	CloseIcon.addPixmap(normalPixmap, QIcon::Normal);
-	CloseIcon.addPixmap(internal::createTransparentPixmap(normalPixmap, 0.25),
-	    QIcon::Disabled);
 	CloseButton->setIcon(
 	    _this->style()->standardIcon(QStyle::SP_TitleBarCloseButton));
 	CloseButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
@@ -33,14 +33,19 @@ HEADERS += \
     DockAreaWidget.h \
     DockAreaTabBar.h \
     DockContainerWidget.h \
+    DockLayoutBuilder.h \
+    DockLayoutJournal.h \
+    DockLayoutModel.h \
     DockManager.h \
     DockWidget.h \
     DockWidgetTab.h \ 
+    DockWidgetProfiler.h \
     DockingStateReader.h \
     FloatingDockContainer.h \
     FloatingOverlay.h \
     DockOverlay.h \
     DockSplitter.h \
+    DockStateStream.h \
     DockAreaTitleBar.h \
     ElidingLabel.h \
     IconProvider.h
@@ -51,14 +56,19 @@ SOURCES += \
     DockAreaWidget.cpp \
     DockAreaTabBar.cpp \
     DockContainerWidget.cpp \
+    DockLayoutBuilder.cpp \
+    DockLayoutJournal.cpp \
+    DockLayoutModel.cpp \
     DockManager.cpp \
     DockWidget.cpp \
     DockingStateReader.cpp \
     DockWidgetTab.cpp \
+    DockWidgetProfiler.cpp \
     FloatingDockContainer.cpp \
     FloatingOverlay.cpp \
     DockOverlay.cpp \
     DockSplitter.cpp \
+    DockStateStream.cpp \
     DockAreaTitleBar.cpp \
     ElidingLabel.cpp \
     IconProvider.cpp
@@ -0,0 +1,122 @@
+//============================================================================
+/// \file   DockStateBenchmark.cpp
+/// \brief  Benchmarks for saving and restoring the dock manager state
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QtTest>
+#include <QMainWindow>
+#include <QLabel>
+
+#include "DockManager.h"
+#include "DockAreaWidget.h"
+#include "DockWidget.h"
+
+using namespace ads;
+
+/**
+ * Measures restoreState() for generated layouts of different sizes and
+ * saveState() for the different state compression levels
+ */
+class CDockStateBenchmark : public QObject
+{
+	Q_OBJECT
+private:
+	QMainWindow* MainWindow = nullptr;
+	CDockManager* DockManager = nullptr;
+	CDockManager::ConfigFlags ConfigFlags;
+
+	/**
+	 * Fills the dock manager with the given number of dock widgets.
+	 * The widgets are split alternately to the right and to the bottom of
+	 * the previous dock area and every third widget is added as a tab
+	 */
+	void createLayout(int DockWidgetCount)
+	{
+		CDockAreaWidget* DockArea = nullptr;
+		for (int i = 0; i < DockWidgetCount; ++i)
+		{
+			auto DockWidget = new CDockWidget(QString("Widget %1").arg(i));
+			DockWidget->setWidget(new QLabel(QString("Label %1").arg(i)));
+			DockWidgetArea Area = (i % 2) ? RightDockWidgetArea : BottomDockWidgetArea;
+			if (DockArea && (i % 3 == 0))
+			{
+				Area = CenterDockWidgetArea;
+			}
+			DockArea = DockManager->addDockWidget(Area, DockWidget, DockArea);
+		}
+	}
+
+private slots:
+	void initTestCase()
+	{
+		ConfigFlags = CDockManager::configFlags();
+	}
+
+	void init()
+	{
+		MainWindow = new QMainWindow();
+		DockManager = new CDockManager(MainWindow);
+		MainWindow->resize(1600, 1200);
+		MainWindow->show();
+	}
+
+	void cleanup()
+	{
+		delete MainWindow;
+		MainWindow = nullptr;
+		DockManager = nullptr;
+		CDockManager::setConfigFlags(ConfigFlags);
+	}
+
+	void restoreState_data()
+	{
+		QTest::addColumn<int>("DockWidgetCount");
+		QTest::newRow("10 widgets") << 10;
+		QTest::newRow("100 widgets") << 100;
+		QTest::newRow("500 widgets") << 500;
+	}
+
+	void restoreState()
+	{
+		QFETCH(int, DockWidgetCount);
+		createLayout(DockWidgetCount);
+		QCoreApplication::processEvents();
+		QByteArray State = DockManager->saveState();
+		QBENCHMARK
+		{
+			QVERIFY(DockManager->restoreState(State));
+		}
+	}
+
+	void saveState_data()
+	{
+		QTest::addColumn<int>("CompressionLevel");
+		QTest::newRow("level 0") << 0;
+		QTest::newRow("level 1") << 1;
+		QTest::newRow("level 6") << 6;
+		QTest::newRow("level 9") << 9;
+	}
+
+	void saveState()
+	{
+		QFETCH(int, CompressionLevel);
+		CDockManager::setConfigFlag(CDockManager::XmlCompressionEnabled, true);
+		DockManager->setStateCompressionLevel(CompressionLevel);
+		createLayout(500);
+		QCoreApplication::processEvents();
+		QByteArray State;
+		QBENCHMARK
+		{
+			State = DockManager->saveState();
+		}
+		qInfo("Compression level %d: state size %d bytes", CompressionLevel,
+			State.size());
+		QVERIFY(DockManager->restoreState(State));
+	}
+};
+
+QTEST_MAIN(CDockStateBenchmark)
+#include "DockStateBenchmark.moc"
@@ -0,0 +1,6 @@
+include(tests.pri)
+
+TARGET = DockStateBenchmark
+
+SOURCES += \
+	DockStateBenchmark.cpp
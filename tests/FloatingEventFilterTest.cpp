@@ -0,0 +1,112 @@
+//============================================================================
+/// \file   FloatingEventFilterTest.cpp
+/// \brief  Tests the application event filter of floating dock containers
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QtTest>
+#include <QMainWindow>
+#include <QLabel>
+
+#include "DockManager.h"
+#include "FloatingDockContainer.h"
+
+using namespace ads;
+
+/**
+ * Floating container that counts the invocations of its event filter
+ */
+class CCountingFloatingContainer : public CFloatingDockContainer
+{
+public:
+	int FilterCount = 0;
+
+	CCountingFloatingContainer(CDockManager* DockManager)
+		: CFloatingDockContainer(DockManager)
+	{}
+
+	void simulateDragStart()
+	{
+		startDragging(QPoint(10, 10), QSize(200, 100), nullptr);
+	}
+
+protected:
+	virtual bool eventFilter(QObject *watched, QEvent *event) override
+	{
+		++FilterCount;
+		return CFloatingDockContainer::eventFilter(watched, event);
+	}
+};
+
+
+/**
+ * Checks that the floating container only filters the events of the
+ * application while it is dragged
+ */
+class CFloatingEventFilterTest : public QObject
+{
+	Q_OBJECT
+private:
+	static const int EventCount = 1000;
+	QMainWindow* MainWindow = nullptr;
+	CDockManager* DockManager = nullptr;
+	CCountingFloatingContainer* FloatingWidget = nullptr;
+	QLabel* Receiver = nullptr;
+
+	void postUnrelatedEvents()
+	{
+		for (int i = 0; i < EventCount; ++i)
+		{
+			QCoreApplication::postEvent(Receiver, new QEvent(QEvent::User));
+		}
+		QCoreApplication::sendPostedEvents(Receiver, QEvent::User);
+	}
+
+private slots:
+	void init()
+	{
+		MainWindow = new QMainWindow();
+		DockManager = new CDockManager(MainWindow);
+		FloatingWidget = new CCountingFloatingContainer(DockManager);
+		Receiver = new QLabel("Receiver", MainWindow);
+		MainWindow->show();
+		FloatingWidget->show();
+		QCoreApplication::processEvents();
+		FloatingWidget->FilterCount = 0;
+	}
+
+	void cleanup()
+	{
+		delete MainWindow;
+		MainWindow = nullptr;
+		DockManager = nullptr;
+		FloatingWidget = nullptr;
+		Receiver = nullptr;
+	}
+
+	void idleContainerFiltersNoEvents()
+	{
+		postUnrelatedEvents();
+		QCOMPARE(FloatingWidget->FilterCount, 0);
+	}
+
+	void draggedContainerFiltersEvents()
+	{
+		FloatingWidget->simulateDragStart();
+		postUnrelatedEvents();
+		QVERIFY(FloatingWidget->FilterCount > 0);
+
+		// The mouse release finishes the drag and removes the filter again
+		QMouseEvent Release(QEvent::MouseButtonRelease, QPointF(0, 0),
+			Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+		QCoreApplication::sendEvent(Receiver, &Release);
+		FloatingWidget->FilterCount = 0;
+		postUnrelatedEvents();
+		QCOMPARE(FloatingWidget->FilterCount, 0);
+	}
+};
+
+QTEST_MAIN(CFloatingEventFilterTest)
+#include "FloatingEventFilterTest.moc"
@@ -0,0 +1,7 @@
+include(tests.pri)
+
+TARGET = FloatingEventFilterTest
+CONFIG += testcase
+
+SOURCES += \
+	FloatingEventFilterTest.cpp
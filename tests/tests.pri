@@ -0,0 +1,33 @@
+ADS_OUT_ROOT = $${OUT_PWD}/..
+
+DESTDIR = $${ADS_OUT_ROOT}/lib
+QT += core gui widgets testlib
+CONFIG += c++14
+CONFIG += debug_and_release
+CONFIG -= app_bundle
+DEFINES += QT_DEPRECATED_WARNINGS
+
+adsBuildStatic {
+    DEFINES += ADS_STATIC
+}
+
+LIBS += -L$${ADS_OUT_ROOT}/lib
+
+# Dependency: AdvancedDockingSystem (shared)
+CONFIG(debug, debug|release){
+    win32 {
+        LIBS += -lqtadvanceddockingd
+    }
+    else:mac {
+        LIBS += -lqtadvanceddocking_debug
+    }
+    else {
+        LIBS += -lqtadvanceddocking
+    }
+}
+else{
+    LIBS += -lqtadvanceddocking
+}
+
+INCLUDEPATH += ../src
+DEPENDPATH += ../src